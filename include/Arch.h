@@ -11,13 +11,27 @@
 #define PROSE_COMPILER_ARCH_H
 
 #include "EnqueueStructures.h"
+#include "LockstepPool.h"
 #include "RuntimeStats_t.h"
 #include "global.h"
+#include <functional>
+#include <memory>
 #include <unordered_map>
 #include <map>
 #include <vector>
 
-extern std::unordered_map<int, int> state_updates;
+using enqueue_job_f_t = std::function<void(Job *)>;
+
+struct ChromeTrace;
+
+// Where a unit's cycles went over a get_cycles() run
+struct UnitBreakdown {
+  uint64_t compute = 0;
+  uint64_t read_stall = 0; // waiting on reads with the stage's compute done
+  uint64_t write_stall = 0;// waiting on writes with the stage's compute done
+  uint64_t dep_wait = 0;   // no job while other units still work on the graph
+  uint64_t idle = 0;       // the whole machine is idle
+};
 
 struct Arch {
   std::vector<State *> states;
@@ -29,14 +43,139 @@ struct Arch {
   int *n_idle_units = nullptr;
   int total_idle = 0;
 
+  std::vector<uint64_t> active_cycles;// per unit, over the whole get_cycles() run
+  std::vector<UnitBreakdown> unit_breakdown;
+  JobList dispatched_jobs;            // in dispatch order
+  ChromeTrace *trace = nullptr;       // -trace
+  bool verbose = true;                // final cycle line and DRAMSim3 stats after each run
+
+  // Called at the start of every cycle so drivers can inject jobs while the simulation runs.
+  // The run continues while the hook returns true, even if the machine is idle.
+  std::function<bool(const enqueue_job_f_t &)> cycle_hook;
+
+  // Called once, at the start of the first cycle at or after fork_cycle (-fork_at)
+  uint64_t fork_cycle = UINT64_MAX;
+  std::function<void()> fork_hook;
+
+  bool unpinned = false;// released jobs ignore their requested core
+
+  // Called at the start of the first cycle at or after checkpoint_cycle with no DRAM request in
+  // flight (-checkpoint). It saves the run with save_run() and sets the next checkpoint_cycle. The
+  // run is never held back for it, a checkpoint still pending checkpoint_warn_after cycles late warns.
+  uint64_t checkpoint_cycle = UINT64_MAX;
+  std::function<void()> checkpoint_hook;
+  static constexpr uint64_t checkpoint_warn_after = 10000;
+
+  // Called once the run is set up, before its first cycle (-restore). It replaces the fresh run
+  // with a saved one through load_run().
+  std::function<void()> restore_hook;
+
+  // The run at the start of the current cycle, for the hooks above. The graph and the units are
+  // not saved, only their progress, so a run is loaded into an arch and graph built the same way.
+  // DRAMSim3 cannot save its state, DRAM must have no request in flight.
+  void save_run(std::ostream &out);
+  void load_run(std::istream &in);
+
   Arch() = default;
+  virtual ~Arch();// deletes the units
 
   void init_waveforms();
 
   RuntimeStats_t *get_cycles(TimeBasedEnqueue &time_enqueues);
 
+  // Queues a job whose dependencies are met, on its requested core or the least loaded unit of its
+  // type. Called for a job's children when its unit finishes it.
+  void enqueue_job(Job *job);
+
+  protected:
+  // Units stepped by one host thread with -sim_threads, and what their steps changed outside them.
+  // Lanes are merged into the machine in unit order once every thread is done.
+  struct alignas(64) StepLane {
+    int begin = 0, end = 0;// units [begin, end)
+    int total_idle = 0;
+    std::vector<int> n_idle_units;
+    decltype(to_enqueue) transactions;
+    std::vector<Job *> finished;
+  };
+
+  // Steps units [begin, end) by one cycle, in index order, into `lane`, or straight into the machine
+  // without one. Frontends with a fixed set of unit types override this to call their units without
+  // virtual dispatch.
+  virtual void increment_units(int begin, int end, StepLane *lane);
+
+  // Steps unit `i`, statically dispatched when T is a final unit type. Units without a job and
+  // units inside a skipped compute stage have nothing to step.
+  template<typename T>
+  void increment_unit(int i, T *unit, StepLane *lane) {
+    if (gcycles < resume_at[i]) return;
+    if (skip_from[i] < resume_at[i]) credit_skipped(i, gcycles);
+    Job *job = unit->j;
+    bool busy = lane ? unit->increment(lane->total_idle, lane->n_idle_units.data())
+                     : unit->increment(total_idle, n_idle_units);
+    if (busy) {
+      per_array_act[i]++;
+      active_cycles[i]++;
+    }
+    if (unit->j == nullptr) {
+      unit_idled(i);
+      if (lane) {
+        lane->finished.push_back(job);
+      } else {
+        finish_job(job);
+      }
+    } else if (unit->min_stage_cycles > 1) {
+      skip_stage(i, unit);
+    }
+  }
+
   private:
+  // get_cycles() progress outside the units, members so checkpoints can save it
+  struct RunProgress {
+    TimeBasedEnqueue *enqueues = nullptr;
+    RuntimeStats_t *stats = nullptr;// one per time point
+    int phase_idx = 0;
+    uint64_t phase_cycles = 0;
+    uint64_t next_phase = 0;
+    int n_types = 0;
+    int dram_cmds = 0;
+    double diff_accumulator_mem = 0;
+    JobList jobs;// every job of the run, checkpoints name jobs by their index here
+    std::unordered_map<Job *, int> job_ids;
+  } run;
+  uint64_t run_fingerprint();// of the graph and the units, a checkpoint only loads into the same
+
   bool have_inited = false;
+  std::vector<std::vector<Job *>> core_queues;// per unit, jobs waiting to be dispatched
+  uint64_t *per_array_act = nullptr;         // per unit, active cycles in the current phase
+  void finish_job(Job *job);                  // counts the job and releases its ready children
+
+  // With -sim_threads, every thread steps a contiguous range of units each cycle. Units only meet
+  // through the DRAM request queue, which takes requests in unit order every cycle, and through job
+  // releases, so the threads synchronise every cycle and their lanes are merged in unit order.
+  std::unique_ptr<LockstepPool> step_pool;// none when stepping on one thread
+  std::vector<StepLane> step_lanes;
+  std::vector<char> finishing;// per unit, finished this cycle with its children not released yet
+  void start_lanes(int n_types);
+  void stop_lanes();
+  void step_units();
+  void merge_lanes();
+
+  // Only units with work are visited every cycle. A stage with no memory traffic left only counts
+  // its compute cycles down, so the unit is not stepped again until the last of them. Cycles of
+  // such stages, and of units without a job, are credited to the counters in bulk. Per unit, kept
+  // in contiguous arrays so the per-cycle scans skip the unit objects.
+  static constexpr uint64_t never = UINT64_MAX;
+  std::vector<uint64_t> resume_at;  // next cycle the unit is stepped, `never` without a job
+  std::vector<uint64_t> skip_from;  // first skipped compute cycle not credited yet
+  std::vector<uint64_t> idle_from;  // first cycle without a job not credited yet
+  std::vector<uint64_t> idle_mark;  // machine_idle at idle_from
+  uint64_t machine_idle = 0;        // cycles so far with every unit idle and nothing queued
+  void skip_stage(int i, State *unit);
+  void credit_skipped(int i, uint64_t end);// credits the skipped cycles before `end`
+  void credit_all_skipped();               // credits every skipped cycle up to gcycles
+  void unit_idled(int i);
+  void credit_idle(int i);                 // credits the unit's cycles without a job up to gcycles
+  void wake_units();                       // ends every skipped stage, its cycles are stepped again
 };
 
 #endif//PROSE_COMPILER_ARCH_H
@@ -0,0 +1,32 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_CHECKPOINT_H
+#define PROSE_COMPILER_CHECKPOINT_H
+
+#include "Arch.h"
+#include <string>
+
+// Saves a run to a file as it goes, and resumes a saved run, e.g. one that crashed hours in. The
+// file holds the progress of every unit and job, the queued DRAM requests and the statistics so
+// far; a restored run rebuilds the graph and the units from the same command line and loads them.
+// DRAMSim3 cannot save its state, so a checkpoint is taken at a cycle with no DRAM request in
+// flight, and a restored run starts on fresh DRAM: idle banks, refresh timers and statistics.
+struct CheckpointConfig {
+  std::string file;           // -checkpoint
+  uint64_t every = 10000000;  // -checkpoint_every, cycles between checkpoints
+  std::string restore;        // -restore
+};
+
+extern CheckpointConfig checkpoint_config;
+
+// Checks the run can be checkpointed or restored and arms `arch` to do so
+void setup_checkpoints(Arch *arch);
+
+#endif//PROSE_COMPILER_CHECKPOINT_H
@@ -0,0 +1,26 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_CRITICALPATH_H
+#define PROSE_COMPILER_CRITICALPATH_H
+
+#include "Arch.h"
+#include <string>
+
+extern std::string critical_path_file;// -critical_path, empty = no analysis
+
+// Walks back from the last job to finish in the last get_cycles() run. Each step goes to the job
+// that held the unit if the job had to wait for one, otherwise to the parent whose completion
+// released it. The path is split into compute per unit type, memory stalls, dispatch waits and
+// time before the job was injected, and that breakdown is printed. Every job's slack is written to
+// a CSV file: how much later it could have finished without moving its children, the next job on
+// its unit or the end of the run.
+void write_critical_path(const Arch *arch, const std::string &fname);
+
+#endif//PROSE_COMPILER_CRITICALPATH_H
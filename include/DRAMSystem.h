@@ -0,0 +1,48 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_DRAMSYSTEM_H
+#define PROSE_COMPILER_DRAMSYSTEM_H
+
+#include "LockstepPool.h"
+#include "memory_system.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace mem {
+  // JedecDRAMSystem whose channel controllers tick on a pool of host threads. Each thread owns a
+  // fixed slice of the channels and, every memory cycle, drains their finished transactions and
+  // ticks them, the same per-controller sequence as the serial ClockTick. The completions are then
+  // handed to the callbacks on the calling thread in channel order, so results match serial mode
+  // exactly. With one thread it is the plain serial system.
+  class ParallelDRAMSystem : public dramsim3::JedecDRAMSystem {
+  public:
+    ParallelDRAMSystem(dramsim3::Config &config, const std::string &output_dir,
+                       std::function<void(uint64_t)> read_callback, std::function<void(uint64_t)> write_callback,
+                       int n_threads);
+    void ClockTick() override;
+
+  private:
+    // Finished transactions of one channel, one memory cycle's worth
+    struct Done {
+      std::vector<std::pair<uint64_t, int>> trans;
+    };
+
+    void tick_slice(int t);
+
+    std::unique_ptr<LockstepPool> pool;// none with one thread
+    std::vector<Done> done;            // by channel
+    std::vector<size_t> bounds;        // thread t ticks channels [bounds[t], bounds[t + 1])
+  };
+}// namespace mem
+
+#endif//PROSE_COMPILER_DRAMSYSTEM_H
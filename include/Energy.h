@@ -0,0 +1,44 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_ENERGY_H
+#define PROSE_COMPILER_ENERGY_H
+
+#include "Arch.h"
+#include <string>
+
+// Energy coefficients in pJ, overridable with a `-energy_params` file of `<name> <value>` lines
+struct EnergyConfig {
+  std::string file;               // -energy, report file, empty = no energy model
+  uint64_t window = 100000;       // -power_window, cycles per power sample
+  double sa_mac_pj = 0.3;         // per MAC in the systolic array...
+  double sa_mac_pj_per_sz = 0.002;// ...plus this much per PE along the array edge (operand wires)
+  double vu_op_pj = 0.5;          // per vector unit element operation
+  double sram_pj_per_byte = 0.8;  // per byte moved through the on-chip buffers
+  double sa_leak_pj_per_pe = 0.01;// per PE per cycle
+  double vu_leak_pj_per_lane = 0.02;
+  double dram_pj_per_byte = 30;   // only used when DRAMSim3 wrote no energy stats
+
+  void load(const std::string &params_file);
+};
+
+extern EnergyConfig energy_config;
+
+// Energy of the last get_cycles() run. Compute energy comes from the ops each job executed, SRAM
+// energy from the bytes it moved, leakage from each unit's size and DRAM energy from DRAMSim3's
+// per-channel totals, shared out over the jobs by their DRAM bytes. Prints the totals with average
+// and peak power. A .json file gets one document, otherwise the per-layer table (energy, average
+// power, GOPS/W) goes to a CSV file and the power samples to <name>_power.csv next to it.
+void write_energy(const Arch *arch, const std::string &fname);
+
+// Keeps the cycle count and DRAMSim3 energy of the run that just finished for write_energy(), for
+// when more runs follow before the report (-whatif reports its baseline run)
+void snapshot_energy_run();
+
+#endif//PROSE_COMPILER_ENERGY_H
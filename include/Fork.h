@@ -0,0 +1,41 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_FORK_H
+#define PROSE_COMPILER_FORK_H
+
+#include "Arch.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Branches a run into variants at a cycle. The process forks once per variant, so each branch
+// starts from the exact machine state, DRAMSim3 included, and only simulates from the fork on.
+// A variant is a '+'-joined list of
+//   ideal_mem      memory completes with zero latency and unlimited bandwidth
+//   ideal_compute  stages take no compute cycles
+//   unpinned       released jobs go to the least loaded unit of their type, not their requested core
+// and writes its outputs next to the normal ones, named with the variant.
+struct ForkConfig {
+  uint64_t at = 0;                  // -fork_at
+  std::vector<std::string> variants;// -fork, one per branch
+  bool enabled() const { return !variants.empty(); }
+};
+
+extern ForkConfig fork_config;
+
+// Checks the variants and arms `arch` to fork once its run reaches the fork cycle. `out` is the
+// statistics file, a branch reopens it under its own name.
+void setup_forks(Arch *arch, FILE *out);
+
+// Call once every output is written. A branch reports its cycles to the parent and returns, the
+// parent waits for every branch and prints their results.
+void finish_forks();
+
+#endif//PROSE_COMPILER_FORK_H
@@ -24,25 +24,54 @@ struct Job {
   int task_idx;
   int core_id = -1;  // Core ID for parallel scheduling (-1 = any core)
   int job_idx;
+  int act_width;   // bytes per activation element, from the layer's precision
+  int weight_width;// bytes per weight element
+  bool writes_output = true;// false when the output stays in the on-chip buffer or there is none
 
   std::vector<Job *> children;
 
   int rem_deps;
+  int n_deps = 0;// rem_deps before the run, restored by reset()
   bool is_done = false;
+  uint64_t ready_cycle = 0; // cycle the job's dependencies were met and it was queued
+  uint64_t start_cycle = 0; // cycle the job was dispatched to a unit
+  uint64_t finish_cycle = 0;// cycle the job completed
+
+  // Timeline records
+  int layer_idx;                    // index into layer_names of the layer that built the job
+  int unit_idx = -1;                // unit the job was dispatched to
+  uint64_t first_read_cycle = 0;    // cycle the first read returned from memory
+  uint64_t bytes_read = 0, bytes_written = 0;
+  uint64_t read_stall_cycles = 0;   // cycles the unit waited on reads
+  uint64_t write_stall_cycles = 0;  // cycles the unit waited on writes
+  uint64_t ops = 0;                 // MACs or vector element operations executed, for the energy model
   Job(uint64_t alloc_size);
+  virtual ~Job() = default;
 
   void add_child(Job *j) {
     children.push_back(j);
     j->rem_deps += 1;
+    j->n_deps += 1;
   }
 
-  void reset() {
+  // Returns the job to its state before simulation so a built graph can run again. Only this job
+  // is reset, reset every job of the graph (see collect_jobs).
+  virtual void reset() {
     addr = addr_hold;
-    for (auto *child: children) {
-      child->reset();
-    }
+    rem_deps = n_deps;
+    is_done = false;
+    ready_cycle = start_cycle = finish_cycle = 0;
+    unit_idx = -1;
+    first_read_cycle = 0;
+    bytes_read = bytes_written = 0;
+    read_stall_cycles = write_stall_cycles = 0;
+    ops = 0;
   }
 
+  // Checkpoints (Checkpoint.h) save how far the job got, the graph itself is rebuilt from the model
+  virtual void save(std::ostream &out) const;
+  virtual void load(std::istream &in);
+
   virtual std::string get_job_dims_string() const = 0;
   void printDetails() const {
     std::cout << "Job Type: " << get_type()
@@ -60,4 +89,7 @@ using JobPair = std::pair<JobList, JobList>;
 
 void jobs_to_dot(std::vector<Job *> &jobs, const std::string &fname = "jobs.dot");
 
+// Every job reachable from `roots`, each listed once
+JobList collect_jobs(const JobList &roots);
+
 #endif//PROSE_COMPILER_JOB_H
@@ -0,0 +1,63 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_JSON_H
+#define PROSE_COMPILER_JSON_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Minimal JSON reader for model graphs and tool interchange files.
+namespace json {
+  struct Value {
+    enum Type {
+      null_t = 0,
+      bool_t,
+      number_t,
+      string_t,
+      array_t,
+      object_t
+    };
+    Type type = null_t;
+    bool b = false;
+    double num = 0;
+    std::string str;
+    std::vector<Value> arr;
+    std::map<std::string, Value> obj;
+
+    bool is_null() const { return type == null_t; }
+    bool is_number() const { return type == number_t; }
+    bool is_string() const { return type == string_t; }
+    bool is_array() const { return type == array_t; }
+    bool is_object() const { return type == object_t; }
+
+    // Returns the member or nullptr if this is not an object or the key is missing
+    const Value *get(const std::string &key) const;
+    const Value &at(const std::string &key) const;
+
+    int64_t as_int() const;
+    double as_double() const;
+    const std::string &as_string() const;
+    std::vector<int64_t> as_int_vector() const;
+
+    // Convenience accessors with a fallback for missing members
+    int64_t get_int(const std::string &key, int64_t dflt) const;
+    double get_double(const std::string &key, double dflt) const;
+    std::string get_string(const std::string &key, const std::string &dflt) const;
+  };
+
+  Value parse(const std::string &text);
+  Value parse_file(const std::string &fname);
+
+  std::string escape(const std::string &s);
+}// namespace json
+
+#endif//PROSE_COMPILER_JSON_H
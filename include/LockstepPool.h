@@ -0,0 +1,63 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_LOCKSTEPPOOL_H
+#define PROSE_COMPILER_LOCKSTEPPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent host threads that run one task together and meet at a barrier, for work handed out
+// every simulated cycle. Workers spin between tasks, so all pools of the process together never
+// have more threads than the host has cores: the calling thread, shared by every pool, plus the
+// workers each pool took from what earlier pools left. Workers that see no task for a while sleep
+// until the next one.
+class LockstepPool {
+public:
+  explicit LockstepPool(int n_threads);
+  ~LockstepPool();
+
+  int size() const { return n_threads; }
+
+  // Calls f(t) for every thread index t, f(0) on the calling thread, and returns once all are
+  // done. An exception thrown by any of them is rethrown here.
+  template<typename F>
+  void run(F &f) {
+    task = [](void *ctx, int t) { (*static_cast<F *>(ctx))(t); };
+    task_ctx = &f;
+    run_task();
+  }
+
+private:
+  void run_task();
+  void worker(int t);
+
+  int n_threads;
+  void (*task)(void *, int) = nullptr;
+  void *task_ctx = nullptr;
+  std::vector<std::thread> workers;
+  std::vector<std::exception_ptr> errors;// by thread
+  std::atomic<uint64_t> generation{0};
+  std::atomic<int> finished{0};
+  std::atomic<bool> stop{false};
+
+  // Sleeping workers, woken by the next task
+  std::mutex park_mutex;
+  std::condition_variable park_cv;
+  std::atomic<int> parked{0};
+  void wait_for_task(uint64_t seen);
+  void start_task();
+};
+
+#endif//PROSE_COMPILER_LOCKSTEPPOOL_H
@@ -14,6 +14,7 @@
 
 #include "Job.h"
 #include "config.h"
+#include "frontends/LayerParser.h"
 
 
 void connectJobLists(JobList& source, JobList& target);
@@ -22,5 +23,20 @@ void printJobQueue(const std::vector<Job *> &job_queue);
 
 void connectJobs(JobPair& parent, JobPair& child);
 
+// Connects built layers by their named tensors. Layers without explicit inputs depend on the
+// previous layer, so a file without tensor names still forms a chain. Fills the indices of the
+// layers with no producers (roots) and with no consumers (sinks).
+void connectLayerGraph(const std::vector<LayerConfig> &configs, std::vector<JobPair> &layers,
+                       std::vector<int> &roots, std::vector<int> &sinks);
+
+// Names of the layers jobs are built for, Job::layer_idx indexes into it
+extern std::vector<std::string> layer_names;
+
+// Index of the layer at `position` in a model, registered on first use so that repeated instances
+// of the model share their layer records
+int layer_index(const LayerConfig &config, int position);
+// Index of the layer named `name`, registered the same way
+int layer_index(const std::string &name);
+
 
 #endif // PROSE_COMPILER_NNLAYERS_H
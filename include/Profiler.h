@@ -0,0 +1,115 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_PROFILER_H
+#define PROSE_COMPILER_PROFILER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Self-profiling of the simulator's hot paths. Regions are timed with the TSC through scoped
+// counters, building with -DNO_SELF_PROFILE compiles them out. Reading the TSC costs about as much as
+// a small region, so only one simulated cycle in sample_period is timed and the total is scaled by
+// the call counts.
+namespace prof {
+  enum Region {
+    INCREMENT,   // State::increment of all units
+    DISPATCH,    // moving queued jobs onto idle units
+    ENQUEUE_TX,  // mem::try_enqueue_tx
+    CLOCK_TICK,  // DRAM ClockTick, without the completion callbacks it makes
+    MEM_CALLBACK,// DRAM completion callbacks
+    N_REGIONS
+  };
+
+  struct Counter {
+    uint64_t ticks = 0;       // over the sampled calls
+    uint64_t calls = 0;
+    uint64_t sampled_calls = 0;
+  };
+
+  extern Counter counters[N_REGIONS];
+
+  const uint64_t sample_period = 64;
+  const uint64_t max_sample_ticks = 1 << 20;// longer samples were preempted and are dropped
+  extern bool sampling;// set for the cycles that are timed
+  extern uint64_t sample_rng;
+  extern uint64_t read_overhead;// ticks one now() adds to every sampled region
+
+  // Unit stages often last a multiple of the array size, so the sampled cycles are picked with a
+  // xorshift generator rather than every sample_period-th cycle
+  inline void begin_cycle() {
+    sample_rng ^= sample_rng << 13;
+    sample_rng ^= sample_rng >> 7;
+    sample_rng ^= sample_rng << 17;
+    sampling = sample_rng % sample_period == 0;
+  }
+
+  inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+
+  // A region nested in another, e.g. the callbacks a ClockTick makes, is taken out of the outer one's time
+  struct Scope;
+  extern Scope *open_scope;
+
+  struct Scope {
+    Region r;
+    uint64_t t0;
+    uint64_t nested = 0;// sampled ticks of the regions inside this one
+    Scope *outer;
+    explicit Scope(Region r) : r(r), t0(sampling ? now() : 0), outer(open_scope) { open_scope = this; }
+    ~Scope() {
+      open_scope = outer;
+      counters[r].calls++;
+      if (t0) {
+        uint64_t d = now() - t0;
+        if (outer) outer->nested += d + read_overhead;
+        d -= std::min(d, nested);
+        if (d < max_sample_ticks) {
+          counters[r].ticks += d;
+          counters[r].sampled_calls++;
+        }
+      }
+    }
+  };
+
+  // Records the host clock and the TSC at startup so that ticks can be converted to seconds
+  void start();
+  // Host time per region, simulated cycles per second and DRAM transactions per second
+  void print_summary(uint64_t sim_cycles, uint64_t dram_transactions);
+
+  extern int progress_interval_ms;// -progress, 0 = no progress line
+
+  // Rate-limits the progress line to one every progress_interval_ms of host time. The clock is
+  // only read every 4096 calls.
+  struct ProgressReporter {
+    bool due();
+
+  private:
+    uint32_t calls = 0;
+    std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+  };
+}// namespace prof
+
+#ifdef NO_SELF_PROFILE
+#define PROF_SCOPE(region)
+#else
+#define PROF_SCOPE(region) prof::Scope prof_scope_##region(prof::region)
+#endif
+
+#endif//PROSE_COMPILER_PROFILER_H
@@ -0,0 +1,34 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_SERVER_H
+#define PROSE_COMPILER_SERVER_H
+
+#include "Simulator.h"
+#include <cstdio>
+#include <istream>
+
+// Long-running simulation server. Reads one JSON request per line,
+//   {"id": 1, "arch": {"cores": 2, "sa_sz": 64, "vu_sz": 64, "ws": 0, "freq": 1},
+//    "dram_config": "<ini>", "model": "<layer file>"}
+// with "layers": "<text-format lines>" instead of "model" for inline workloads, and answers each
+// with one JSON line. Arch fields left out take the command-line values. Parsed DRAM configs and
+// built job graphs are kept between requests, so a repeated (arch, DRAM, workload) triple skips
+// parsing and graph construction.
+struct ServerConfig {
+  bool enabled = false;// -server
+  int max_graphs = 16; // -server_cache, built graphs kept, least recently used ones are dropped
+};
+
+extern ServerConfig server_config;
+
+// Serves requests from `in` until EOF or {"cmd": "quit"}. Answers go to `out`, after a ready line.
+void run_server(const cocossim::ArchSpec &defaults, std::istream &in, FILE *out);
+
+#endif//PROSE_COMPILER_SERVER_H
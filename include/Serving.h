@@ -0,0 +1,49 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_SERVING_H
+#define PROSE_COMPILER_SERVING_H
+
+#include "Arch.h"
+#include "frontends/LayerParser.h"
+#include <cstdio>
+#include <functional>
+#include <string>
+
+// Request-arrival driven simulation: each request's graph is injected at its arrival cycle.
+// Requests come from a trace file with one request per line,
+//   <arrival_us> <model_file> [samples]
+// or are generated locally with Poisson (optionally bursty) arrivals of the -i model.
+struct ServingConfig {
+  std::string trace_file;// -serve
+  double rate_per_us = 0;// -rate, mean arrivals per microsecond
+  int n_requests = 100;  // -requests
+  int burst = 1;         // -burst, requests arriving together
+  int seed = 1;          // -seed
+  bool enabled() const { return !trace_file.empty() || rate_per_us > 0; }
+};
+
+extern ServingConfig serving_config;
+
+struct Request {
+  uint64_t arrival;// cycle
+  std::string model_file;
+  int samples = 1;// independent copies of the model graph
+  JobList roots;
+  // Filled in after the run
+  uint64_t first_dispatch = 0;
+  uint64_t finish = 0;
+};
+
+using parser_for_f = std::function<const LayerParser &(const std::string &)>;
+
+// Runs every request on `arch` and writes per-request timings and latency percentiles to `f`
+void run_serving(Arch *arch, const parser_for_f &parser_for, const std::string &default_model, FILE *f);
+
+#endif//PROSE_COMPILER_SERVING_H
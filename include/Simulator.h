@@ -0,0 +1,92 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_SIMULATOR_H
+#define PROSE_COMPILER_SIMULATOR_H
+
+#include "Arch.h"
+#include "frontends/LayerParser.h"
+#include <string>
+#include <vector>
+
+// In-process embedding API of the cocossim library. The simulator core keeps its state in
+// globals, so only one Simulator may run at a time per process. Every run starts from a fresh
+// DRAM system and address space, so it reports the same cycles as a perf_model process would.
+namespace cocossim {
+  // Mirrors the -c, -sa_sz, -vu_sz, -ws and -f flags
+  struct ArchSpec {
+    int cores = 1;
+    int sa_sz = 64;
+    int vu_sz = 64;
+    bool ws = false;
+    float freq_ghz = 1;
+    int batch_size = 1;
+    int dtype_width = 2;// bytes per element of layers without their own precision
+    bool map = false;   // Matmul and Conv layers split by the mapper, see frontends/standard/Mapper.h
+    int map_verify = 0; // mapper candidates simulated per layer
+    bool fuse = false;  // fusable layer pairs keep their intermediates on chip, see frontends/standard/Fusion.h
+    std::string dram_config = "../dramsim3/configs/HBM2_8Gb_x128.ini";
+    std::string dram_output_dir = "./";// DRAMSim3 writes its stats files here
+  };
+
+  struct UnitStats {
+    std::string name;// e.g. SYSTOLIC_ARRAY_0
+    uint64_t active_cycles = 0;
+    UnitBreakdown breakdown;
+  };
+
+  struct LayerStats {
+    std::string name;
+    int jobs = 0;
+    uint64_t start = 0, finish = 0;
+    uint64_t read_stall = 0, write_stall = 0;
+    uint64_t bytes_read = 0, bytes_written = 0;
+  };
+
+  struct RunStats {
+    bool reused_graph = false;// the job graph of an earlier run was reset and run again
+    uint64_t cycles = 0;
+    double time_us = 0;
+    int jobs = 0;
+    uint64_t dram_reads = 0, dram_writes = 0;
+    std::vector<UnitStats> units;
+    std::vector<LayerStats> layers;
+  };
+
+  class Simulator {
+  public:
+    // `quiet` drops the simulator's stdout chatter while it runs
+    explicit Simulator(const ArchSpec &spec, bool quiet = true);
+    Simulator(Simulator &&other) noexcept;
+    Simulator(const Simulator &) = delete;
+    Simulator &operator=(const Simulator &) = delete;
+    ~Simulator();
+
+    // Appends a model: a .json torch.fx graph or a layer file in the text format
+    void load_model(const std::string &fname);
+    // Appends layers given as text-format lines, e.g. "Matmul 256 256 256\nSoftmax 12 128 128"
+    void add_layers(const std::string &text);
+    void clear_model();
+    const std::vector<LayerConfig> &model() const { return configs; }
+    const ArchSpec &arch_spec() const { return spec; }
+
+    // Simulates the model on fresh units and DRAM. The job graph is built on the first run and
+    // reset for later ones until the model changes. Throws std::runtime_error on bad input.
+    RunStats run();
+
+  private:
+    ArchSpec spec;
+    bool quiet;
+    std::vector<LayerConfig> configs;
+    JobList roots, jobs;// built graph, empty until the first run
+    void free_graph();
+  };
+}// namespace cocossim
+
+#endif//PROSE_COMPILER_SIMULATOR_H
@@ -13,24 +13,20 @@
 #include "Job.h"
 #include "perf_enums.h"
 #include <functional>
+#include <iostream>
 #include <set>
 
 #include "Arch.h"
+#include "Waveform.h"
 
-#ifdef VCD
 #define LOG_TO_WAVEFORM(stat_idx, to) \
-  state_updates[stat_idx] = int(to);
-#define UPDATE_STATE(x)                                  \
-  state_updates[STAT_ID(STATE, vcd_idx)] = int(x); \
-  set_state(x);
-#define UPDATE_IDLEMEM(to)                                      \
-  state_updates[STAT_ID(IDLE_FROM_MEMORY, vcd_idx)] = to; \
-  is_idle_from_memory = to
-#else
-#define LOG_TO_WAVEFORM(stat_idx, to)
-#define UPDATE_STATE(x) set_state(x)
-#define UPDATE_IDLEMEM(to)
-#endif
+  if (waveform) waveform->change(stat_idx, (uint64_t) (to))
+#define UPDATE_STATE(x) \
+  set_state(x);         \
+  LOG_TO_WAVEFORM(STAT_ID(STATE, vcd_idx), x)
+#define UPDATE_IDLEMEM(to)    \
+  is_idle_from_memory = to; \
+  LOG_TO_WAVEFORM(STAT_ID(IDLE_FROM_MEMORY, vcd_idx), to)
 
 #ifdef VERBOSE
 #define IFVERB(x) x
@@ -41,64 +37,74 @@
 #define SET_READS(x) mem_read_left_unqueued = mem_read_left = x
 #define SET_WRITES(x) mem_write_left = mem_write_left_unqueued = x
 
-#define TO_IDLE_CLEANUP()                                   \
-  jobs_finished++;                                          \
-  total_idle++;                                             \
-  n_idle_units[get_ty_idx()] += 1;                \
-  for (auto *child: j->children) {                          \
-    child->rem_deps -= 1;                                   \
-    if (child->rem_deps == 0) {                             \
-      IFVERB(std::cout << "enqueuing child " << std::endl); \
-      enqueue_job(child);                                   \
-    }                                                       \
-  }                                                         \
-  j->is_done = true;                                        \
+// The arch releases the job's children once the unit's step returns
+#define TO_IDLE_CLEANUP()          \
+  total_idle++;                    \
+  n_idle_units[get_ty_idx()] += 1; \
+  j->is_done = true;               \
+  j->finish_cycle = gcycles;       \
   j = nullptr
 
 
 
-using enqueue_job_f_t = std::function<void(Job *)>;
-
 struct State {
   int sz;          // Size of the functional array
   Job *j = nullptr;// Job being processed by the array
 
-  uint8_t vcd_idx = 0;// Index for VCD tracing
+  int vcd_idx = 0;// Index for VCD tracing
 
-  int min_stage_cycles;       // Minimum cycles required to read data / shift / whatever
-  int mem_read_left;          // Remaining memory reads to complete
-  int mem_write_left;         // Remaining memory writes to complete
-  int mem_read_left_unqueued; // Unqueued memory reads left
-  int mem_write_left_unqueued;// Unqueued memory writes left
-  int mem_queued;             // Memory operations queued
+  // Cycle and beat counts are 64-bit, a stage of an LLM-scale job can move more than 2^31 bytes
+  int64_t min_stage_cycles = 0;       // Minimum cycles required to read data / shift / whatever
+  int64_t mem_read_left = 0;          // Remaining memory reads to complete
+  int64_t mem_write_left = 0;         // Remaining memory writes to complete
+  int64_t mem_read_left_unqueued = 0; // Unqueued memory reads left
+  int64_t mem_write_left_unqueued = 0;// Unqueued memory writes left
+  int64_t mem_queued = 0;             // Memory operations queued
   int core_memory_priority;
   bool is_idle_from_memory = false;
 
-  int loop_row_tiles; // Number of row tiles in the loop
-  int loop_cols_tiles;// Number of column tiles in the loop
-  int row_i, col_i;   // Current row and column indices
+  int loop_row_tiles = 0; // Number of row tiles in the loop
+  int loop_cols_tiles = 0;// Number of column tiles in the loop
+  int row_i = 0, col_i = 0;// Current row and column indices
 
   int beats_per_wb;// Number of memory beats per write-back
 
   bool activation_in_buffer = false;// Enable DRAM-to-buffer flow simulation if false
 
+  decltype(to_enqueue) *tx_queue = &to_enqueue;// queued transactions, per thread when units step in parallel
+
   virtual ~State() = default;
   State() = delete;
   State(int memory_priority);
 
 
-  void enqueue_writes();
-  void enqueue_reads();
+  // Queue this cycle's share of the stage's memory traffic
+  void enqueue_writes() {
+    if (mem_write_left_unqueued > 0) queue_writes();
+  }
+  void enqueue_reads() {
+    if (mem_read_left_unqueued > 0) queue_reads();
+  }
   void check_idle_from_memory();
   bool process_stage();
-  void state_transfer(int st, int read_amt, int write_amt, int min_cycles);
+  void state_transfer(int st, int64_t read_amt, int64_t write_amt, int64_t min_cycles);
   virtual void init() = 0;
-  virtual bool increment(const enqueue_job_f_t &, int &total_idle, int *n_idle_units) = 0;
+  // Advances the unit by one cycle. Returns whether the unit is busy.
+  virtual bool increment(int &total_idle, int *n_idle_units) = 0;
   virtual void set_state(int st) = 0;
   virtual int get_state() = 0;
+  virtual std::string get_state_string(int st) = 0;
 
   virtual int get_ty_idx() = 0;
   virtual std::string get_ty_string() = 0;
+
+  // Checkpoints (Checkpoint.h) save how far the unit is through its job, the arch saves `j`
+  virtual void save(std::ostream &out);
+  virtual void load(std::istream &in);
+
+private:
+  void queue_writes();
+  void queue_reads();
 };
 
 void vcd_stat_init(int vcd_idx, const char *sig_name);
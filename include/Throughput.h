@@ -0,0 +1,32 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_THROUGHPUT_H
+#define PROSE_COMPILER_THROUGHPUT_H
+
+#include "Arch.h"
+#include "frontends/LayerParser.h"
+#include <cstdio>
+
+// Steady-state pipelined throughput: model iterations are injected back to back, the next one as
+// soon as the previous one's ready jobs have all been dispatched, until the cycles between
+// consecutive iteration completions converge.
+struct ThroughputConfig {
+  double tolerance = 0;// -throughput, max relative spread of the completion intervals in the window
+  int window = 4;      // -tp_window, intervals that must agree
+  int max_inflight = 2;// -tp_inflight, iterations in flight at once
+  int max_iters = 100; // -tp_max_iters, give up converging after this many iterations
+  bool enabled() const { return tolerance > 0; }
+};
+
+extern ThroughputConfig throughput_config;
+
+void run_throughput(Arch *arch, const LayerParser &layerParser, const std::string &model, FILE *f);
+
+#endif//PROSE_COMPILER_THROUGHPUT_H
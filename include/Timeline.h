@@ -0,0 +1,23 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_TIMELINE_H
+#define PROSE_COMPILER_TIMELINE_H
+
+#include "Arch.h"
+#include <string>
+
+extern std::string timeline_file;// -timeline, empty = no timeline
+
+// Writes the per-job records of the last get_cycles() run, their per-layer roll-up and the per-unit
+// cycle breakdown. A .json file gets one document, otherwise the jobs go to a CSV file and the layer
+// and unit tables to <name>_layers.csv and <name>_units.csv next to it.
+void write_timeline(const Arch *arch, const std::string &fname);
+
+#endif//PROSE_COMPILER_TIMELINE_H
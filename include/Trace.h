@@ -0,0 +1,54 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_TRACE_H
+#define PROSE_COMPILER_TRACE_H
+
+#include "Arch.h"
+#include <cstdio>
+#include <string>
+
+extern std::string trace_file;        // -trace, empty = no trace
+extern uint64_t trace_counter_cycles; // -trace_bw, cycles per DRAM bandwidth sample
+
+// Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev). Each unit is a track with its jobs as
+// spans, the unit states nested inside them and memory stalls nested inside the states. DRAM
+// bandwidth is sampled as a counter. Events are built in a buffer that is written out in blocks.
+struct ChromeTrace {
+  ChromeTrace(const std::string &fname, Arch *arch);
+  ~ChromeTrace();
+
+  // Called once per simulated cycle after the units have been incremented
+  void record_cycle(uint64_t cycle);
+  // Closes the spans still open at the end of a get_cycles() run
+  void close_spans(uint64_t cycle);
+
+private:
+  struct Track {
+    Job *job = nullptr;
+    uint64_t job_start = 0;
+    int state = 0;
+    uint64_t state_start = 0;
+    bool stalled = false;
+    uint64_t stall_start = 0;
+  };
+
+  Arch *arch;
+  FILE *f;
+  std::string buf;
+  bool first_event = true;
+  std::vector<Track> tracks;
+  uint64_t last_sample = 0, reads_at_sample = 0, writes_at_sample = 0;
+
+  void emit(const std::string &event);
+  void span(int tid, const std::string &name, const char *cat, uint64_t start, uint64_t end, const std::string &args = "");
+  void sample_bandwidth(uint64_t cycle);
+};
+
+#endif//PROSE_COMPILER_TRACE_H
@@ -0,0 +1,90 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_WAVEFORM_H
+#define PROSE_COMPILER_WAVEFORM_H
+
+#include "global.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct WaveformConfig {
+#ifdef VCD
+  std::string file = "out.vcd";// -vcd, USE_VCD builds dump by default
+#else
+  std::string file;            // -vcd, empty = no waveform
+#endif
+  uint64_t from = 0;           // -vcd_from, first cycle dumped
+  uint64_t to = UINT64_MAX;    // -vcd_to, last cycle dumped
+  std::string units;           // -vcd_units, unit indices such as "0,2-5", empty = all units
+
+  bool keeps_unit(int idx) const;
+};
+
+extern WaveformConfig waveform_config;
+
+// VCD writer for long runs. Value changes are packed into fixed-size records in a ring buffer and a
+// background thread formats and writes them, so the simulation thread never formats or flushes.
+// Signal identifiers are generated, so the number of units is not limited.
+struct WaveformWriter {
+  explicit WaveformWriter(const std::string &fname);
+  ~WaveformWriter();
+
+  // Signals are keyed by their STAT_ID, or PHASE_STATE_IDX for the phase
+  void declare(int stat_id, const std::string &name, int width);
+  // Writes the header and starts the writer thread, no signals can be declared afterwards
+  void begin();
+
+  void change(int stat_id, uint64_t value) {
+    size_t key = stat_id + 1;
+    if (key >= signal_of.size() || signal_of[key] < 0) return;
+    if (gcycles < waveform_config.from) {
+      // Remembered for the window's first time step
+      last[signal_of[key]] = value;
+      return;
+    }
+    if (gcycles > waveform_config.to) return;
+    if (!window_open) open_window();
+    push({gcycles, (uint32_t) signal_of[key], value});
+  }
+
+private:
+  struct Record {
+    uint64_t cycle;
+    uint32_t signal;
+    uint64_t value;
+  };
+  struct Signal {
+    std::string name, id;
+    int width;
+  };
+
+  FILE *f;
+  std::vector<Signal> signals;
+  std::vector<int> signal_of;// STAT_ID + 1 -> index into signals, -1 = not dumped
+  std::vector<uint64_t> last;// value of each signal before -vcd_from
+  bool window_open = false;
+
+  std::vector<Record> ring;
+  std::atomic<size_t> head{0}, tail{0};
+  std::atomic<bool> done{false};
+  std::thread writer;
+
+  void push(const Record &r);
+  // Dumps every signal's value from before the window at its first cycle
+  void open_window();
+  void drain();
+};
+
+extern WaveformWriter *waveform;
+
+#endif//PROSE_COMPILER_WAVEFORM_H
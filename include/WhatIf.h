@@ -0,0 +1,36 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PROSE_COMPILER_WHATIF_H
+#define PROSE_COMPILER_WHATIF_H
+
+#include "Arch.h"
+#include "frontends/LayerParser.h"
+#include <cstdio>
+#include <functional>
+
+// Overrides applied by the unit state machines to find out what bounds a workload
+struct WhatIfConfig {
+  bool ideal_memory = false; // -ideal_mem, reads and writes complete the cycle they are issued
+  bool ideal_compute = false;// -ideal_compute, stages take no compute cycles and only wait on memory
+  bool report = false;       // -whatif, run every mode and print the per-layer attribution
+};
+
+extern WhatIfConfig whatif_config;
+
+// Builds a fresh architecture, with `units_per_type` units of each type when it is > 0
+using make_arch_f_t = std::function<Arch *(int units_per_type)>;
+
+// Runs the model once as configured and once under each of ideal memory, ideal compute and
+// unlimited units (every unit type sized to its job count, core pinning dropped). `arch` takes the
+// baseline run, the other modes get their own architecture from `make_arch`.
+void run_whatif(Arch *arch, const make_arch_f_t &make_arch, const LayerParser &layerParser,
+                const std::string &model, FILE *f);
+
+#endif//PROSE_COMPILER_WHATIF_H
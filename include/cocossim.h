@@ -0,0 +1,96 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+/* C ABI of the cocossim library, for ctypes/cffi and other FFIs. Functions returning int give 0 on
+ * success and -1 on failure, cocossim_last_error() then describes the failure. Only one simulator
+ * may run at a time per process. */
+
+#ifndef COCOSSIM_H
+#define COCOSSIM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct cocossim_sim cocossim_sim;
+
+typedef struct {
+  uint64_t cycles;
+  double time_us;
+  int jobs;
+  uint64_t dram_reads;
+  uint64_t dram_writes;
+  int n_units;
+  int n_layers;
+} cocossim_stats;
+
+typedef struct {
+  uint64_t active;
+  uint64_t compute;
+  uint64_t read_stall;
+  uint64_t write_stall;
+  uint64_t dep_wait;
+  uint64_t idle;
+} cocossim_unit_stats;
+
+typedef struct {
+  int jobs;
+  uint64_t start;
+  uint64_t finish;
+  uint64_t read_stall;
+  uint64_t write_stall;
+  uint64_t bytes_read;
+  uint64_t bytes_written;
+} cocossim_layer_stats;
+
+/* Architecture and model options, cocossim_default_options() fills in the defaults. The strings may
+ * be NULL for the defaults and are copied by cocossim_create_with(). */
+typedef struct {
+  int cores;
+  int sa_sz;
+  int vu_sz;
+  int ws;
+  double freq_ghz;
+  int batch_size;
+  int dtype_width;/* bytes per element of layers without their own precision */
+  int map;        /* Matmul and Conv layers split by the mapper */
+  int map_verify; /* mapper candidates simulated per layer */
+  int fuse;       /* fusable layer pairs keep their intermediates on chip */
+  const char *dram_config;
+  const char *dram_output_dir;/* DRAMSim3 writes its stats files here */
+} cocossim_options;
+
+void cocossim_default_options(cocossim_options *opts);
+
+/* Both return NULL on failure. dram_config may be NULL for the default DRAMSim3 config path. */
+cocossim_sim *cocossim_create(int cores, int sa_sz, int vu_sz, int ws, double freq_ghz, const char *dram_config);
+cocossim_sim *cocossim_create_with(const cocossim_options *opts);
+void cocossim_destroy(cocossim_sim *sim);
+
+int cocossim_load_model(cocossim_sim *sim, const char *fname);
+int cocossim_add_layers(cocossim_sim *sim, const char *text);
+void cocossim_clear_model(cocossim_sim *sim);
+
+int cocossim_run(cocossim_sim *sim, cocossim_stats *stats);
+
+/* Per-unit and per-layer results of the last run. The names stay valid until the next run. */
+int cocossim_get_unit_stats(const cocossim_sim *sim, int unit, cocossim_unit_stats *stats);
+const char *cocossim_unit_name(const cocossim_sim *sim, int unit);
+int cocossim_get_layer_stats(const cocossim_sim *sim, int layer, cocossim_layer_stats *stats);
+const char *cocossim_layer_name(const cocossim_sim *sim, int layer);
+
+const char *cocossim_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COCOSSIM_H */
@@ -10,7 +10,21 @@
 #ifndef PERF_MODEL_ARCHPARSER_H
 #define PERF_MODEL_ARCHPARSER_H
 #include "Arch.h"
+#include "Checkpoint.h"
+#include "CriticalPath.h"
+#include "Energy.h"
+#include "Fork.h"
+#include "Profiler.h"
+#include "Server.h"
+#include "Serving.h"
+#include "Throughput.h"
+#include "Timeline.h"
+#include "Trace.h"
+#include "Waveform.h"
+#include "WhatIf.h"
+#include "frontends/torch/TorchLayer.h"
 #include "global.h"
+#include "memory.h"
 #include <cstring>
 
 extern std::string layer_file;
@@ -28,11 +42,140 @@ struct ArchParser {
         ofile = argv[++i];
       } else if (strcmp(argv[i], "-f") == 0) {
         freq_sa = std::stof(argv[++i]);
+      } else if (strcmp(argv[i], "-timeline") == 0) {
+        timeline_file = argv[++i];
+      } else if (strcmp(argv[i], "-critical_path") == 0) {
+        critical_path_file = argv[++i];
+      } else if (strcmp(argv[i], "-energy") == 0) {
+        energy_config.file = argv[++i];
+      } else if (strcmp(argv[i], "-energy_params") == 0) {
+        energy_config.load(argv[++i]);
+      } else if (strcmp(argv[i], "-power_window") == 0) {
+        energy_config.window = std::stoull(argv[++i]);
+      } else if (strcmp(argv[i], "-trace") == 0) {
+        trace_file = argv[++i];
+      } else if (strcmp(argv[i], "-trace_bw") == 0) {
+        trace_counter_cycles = std::stoull(argv[++i]);
+      } else if (strcmp(argv[i], "-vcd") == 0) {
+        waveform_config.file = argv[++i];
+      } else if (strcmp(argv[i], "-vcd_from") == 0) {
+        waveform_config.from = std::stoull(argv[++i]);
+      } else if (strcmp(argv[i], "-vcd_to") == 0) {
+        waveform_config.to = std::stoull(argv[++i]);
+      } else if (strcmp(argv[i], "-vcd_units") == 0) {
+        waveform_config.units = argv[++i];
+      } else if (strcmp(argv[i], "-progress") == 0) {
+        prof::progress_interval_ms = std::stoi(argv[++i]);
+      } else if (strcmp(argv[i], "-periods") == 0) {
+        periods = std::stoi(argv[++i]);
+      } else if (strcmp(argv[i], "-threads") == 0) {
+        n_threads = std::stoi(argv[++i]);
+      } else if (strcmp(argv[i], "-sim_threads") == 0) {
+        sim_threads = std::stoi(argv[++i]);
+      } else if (strcmp(argv[i], "-dram_threads") == 0) {
+        mem::tick_threads = std::stoi(argv[++i]);
+      } else if (strcmp(argv[i], "-batch") == 0) {
+        batch_size = std::stoi(argv[++i]);
+        if (batch_size < 1) throw std::runtime_error("Error: -batch must be at least 1");
+      } else if (strcmp(argv[i], "-dtype") == 0) {
+        data_type_width = alloc_act_width = alloc_weight_width = dtype_width(argv[++i]);
+      } else if (strcmp(argv[i], "-dt") == 0) {
+        period_dt = std::stoull(argv[++i]);
+      } else if (strcmp(argv[i], "-throughput") == 0) {
+        throughput_config.tolerance = std::stod(argv[++i]);
+      } else if (strcmp(argv[i], "-tp_window") == 0) {
+        throughput_config.window = std::stoi(argv[++i]);
+      } else if (strcmp(argv[i], "-tp_inflight") == 0) {
+        throughput_config.max_inflight = std::stoi(argv[++i]);
+      } else if (strcmp(argv[i], "-tp_max_iters") == 0) {
+        throughput_config.max_iters = std::stoi(argv[++i]);
+      } else if (strcmp(argv[i], "-serve") == 0) {
+        serving_config.trace_file = argv[++i];
+      } else if (strcmp(argv[i], "-rate") == 0) {
+        serving_config.rate_per_us = std::stod(argv[++i]);
+      } else if (strcmp(argv[i], "-requests") == 0) {
+        serving_config.n_requests = std::stoi(argv[++i]);
+      } else if (strcmp(argv[i], "-burst") == 0) {
+        serving_config.burst = std::stoi(argv[++i]);
+      } else if (strcmp(argv[i], "-seed") == 0) {
+        serving_config.seed = std::stoi(argv[++i]);
+      } else if (strcmp(argv[i], "-whatif") == 0) {
+        whatif_config.report = true;
+      } else if (strcmp(argv[i], "-ideal_mem") == 0) {
+        whatif_config.ideal_memory = true;
+      } else if (strcmp(argv[i], "-ideal_compute") == 0) {
+        whatif_config.ideal_compute = true;
+      } else if (strcmp(argv[i], "-fork_at") == 0) {
+        fork_config.at = std::stoull(argv[++i]);
+      } else if (strcmp(argv[i], "-fork") == 0) {
+        fork_config.variants.push_back(argv[++i]);
+      } else if (strcmp(argv[i], "-checkpoint") == 0) {
+        checkpoint_config.file = argv[++i];
+      } else if (strcmp(argv[i], "-checkpoint_every") == 0) {
+        checkpoint_config.every = std::stoull(argv[++i]);
+      } else if (strcmp(argv[i], "-restore") == 0) {
+        checkpoint_config.restore = argv[++i];
+      } else if (strcmp(argv[i], "-server") == 0) {
+        server_config.enabled = true;
+      } else if (strcmp(argv[i], "-server_cache") == 0) {
+        server_config.max_graphs = std::stoi(argv[++i]);
+      } else if (strcmp(argv[i], "-fx_unknown_as_view") == 0) {
+        frontend::torch::fx_config.unknown_as_view = true;
       } else if (strcmp(argv[i], "-h") == 0) {
         std::cerr << "Global Options:\n"
                      "-i <file>     layer input file\n"
                      "-o <file>     output statistic file\n"
-                     "-f <float>    frequency (GHz)\n";
+                     "-f <float>    frequency (GHz)\n"
+                     "-timeline <file> per-job/per-layer timeline with stall attribution (.json or .csv)\n"
+                     "-critical_path <file> critical path breakdown, and every job's slack as CSV\n"
+                     "-energy <file> energy, power and per-layer perf/W report (.json or .csv)\n"
+                     "-energy_params <file> energy coefficients, one '<name> <pJ>' per line\n"
+                     "-power_window <n> cycles per power sample (default 100000)\n"
+                     "-trace <file> Chrome/Perfetto trace of unit and job activity\n"
+                     "-trace_bw <n> cycles per DRAM bandwidth sample in the trace (default 1000)\n"
+                     "-progress <ms> host time between progress lines, 0 = none (default 1000)\n"
+                     "-vcd <file>   VCD waveform of the unit states\n"
+                     "-vcd_from <n> first cycle in the waveform\n"
+                     "-vcd_to <n>   last cycle in the waveform\n"
+                     "-vcd_units <list> units in the waveform, e.g. 0,2-5 (default all)\n"
+                     "-periods <n>  copies of the model enqueued -dt cycles apart (default 1)\n"
+                     "-threads <n>  copies of the model per period (default 1)\n"
+                     "-dt <n>       cycles between periods (default 30000000)\n"
+                     "-batch <n>    batch size of every layer (default 1)\n"
+                     "-dtype <type> element type: int8, fp8, bf16, fp16, fp32 or bytes (default bf16),\n"
+                     "              layers may override it with dtype=<type> and wdtype=<type>\n"
+                     "-dram_threads <n> host threads ticking the DRAM channels, same results (default 1, experimental)\n"
+                     "-sim_threads <n>  host threads stepping the units, same results (default 1, experimental)\n"
+                     "-fx_unknown_as_view  .json graphs: pass unsupported single-input ops through at no cost\n"
+                     "                     instead of failing\n"
+                     "Throughput Options:\n"
+                     "-throughput <float>  run back-to-back iterations until the cycles between completions\n"
+                     "                     agree within this relative tolerance\n"
+                     "-tp_window <n>       completion intervals that must agree (default 4)\n"
+                     "-tp_inflight <n>     iterations in flight at once (default 2)\n"
+                     "-tp_max_iters <n>    iteration limit (default 100)\n"
+                     "Bottleneck Options:\n"
+                     "-whatif         rerun with ideal memory, ideal compute and unlimited units and\n"
+                     "                attribute each layer to what bounds it\n"
+                     "-ideal_mem      memory completes with zero latency and unlimited bandwidth\n"
+                     "-ideal_compute  stages take no compute cycles\n"
+                     "Fork Options:\n"
+                     "-fork_at <n>       cycle the run branches at\n"
+                     "-fork <variant>    branch running on under '+'-joined settings, repeatable:\n"
+                     "                   base, ideal_mem, ideal_compute, unpinned\n"
+                     "Checkpoint Options:\n"
+                     "-checkpoint <file>     save the run to a file as it goes\n"
+                     "-checkpoint_every <n>  cycles between checkpoints (default 10000000)\n"
+                     "-restore <file>        resume a saved run, with the command line it was saved from\n"
+                     "Serving Options:\n"
+                     "-serve <file> arrival trace, one '<arrival_us> <model_file> [samples]' per line\n"
+                     "-rate <float> generate Poisson arrivals of the -i model, requests per microsecond\n"
+                     "-requests <n> number of generated requests (default 100)\n"
+                     "-burst <n>    generated requests arriving together (default 1)\n"
+                     "-seed <n>     random seed for generated arrivals\n"
+                     "Server Options:\n"
+                     "-server           answer JSON requests from stdin, one per line, until EOF\n"
+                     "-server_cache <n> built job graphs kept between requests (default 16)\n";
         if (help_str != "") {
           std::cerr << "Arch Specific Options:\n"
                     << help_str << std::endl;
@@ -10,17 +10,33 @@
 #ifndef LAYERPARSER_H
 #define LAYERPARSER_H
 #include "Job.h"
+#include <istream>
+#include <string>
 #include <vector>
 
 struct LayerConfig {
   std::string layer_type;
   std::vector<int> dimensions;
+  std::vector<std::string> inputs; // named input tensors, empty = output of the previous layer
+  std::vector<std::string> outputs;// named output tensors
+  std::vector<std::string> graph_inputs;// inputs declared as graph inputs, no layer produces them
+  int act_width = 0;                // bytes per activation element, 0 = -dtype
+  int weight_width = 0;             // bytes per weight element, 0 = the activation width
+  bool output_on_chip = false;      // fused with its consumer, the output stays in the on-chip buffer
+  int inputs_on_chip = 0;           // inputs that a fused producer leaves in the on-chip buffer
   LayerConfig(const std::string &&layerType, const std::vector<int> &dimensions) : layer_type(layerType), dimensions(dimensions) {}
   LayerConfig() = default;
 };
 
 
 struct LayerParser {
+  // Reads a layer file into layer configs. The default implementation handles the text format:
+  //   <layer_type> <dim0> <dim1> ... [in=<tensor>,<tensor>] [out=<tensor>] [dtype=<type>] [wdtype=<type>]
+  // and `Input <tensor>,<tensor>` lines declaring the graph inputs that later layers read
+  virtual std::vector<LayerConfig> read_layers(const std::string &fname) const;
+  // Parses text-format lines, `fname` only names the source in error messages
+  static std::vector<LayerConfig> parse_layers(std::istream &in, const std::string &fname);
+
   virtual std::vector<JobPair> make_layers(const std::vector<LayerConfig> &layer_configs) const {
     throw std::runtime_error("LayerParser: Not implemented");
   }
@@ -0,0 +1,46 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PERF_MODEL_FUSION_H
+#define PERF_MODEL_FUSION_H
+
+#include "Job.h"
+#include "frontends/LayerParser.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace frontend::standard {
+  struct FusionConfig {
+    bool enabled = false;// -fuse
+  };
+
+  extern FusionConfig fusion_config;
+
+  // DRAM traffic of the intermediate tensors fused layers keep on chip, since the last reset
+  struct FusionStats {
+    int fused = 0;           // producer/consumer pairs
+    uint64_t write_bytes = 0;// producer outputs no longer written
+    uint64_t read_bytes = 0; // consumer inputs no longer read
+  };
+
+  extern FusionStats fusion_stats;
+
+  // Marks the producer/consumer pairs whose intermediate tensor stays in the on-chip buffer:
+  // Matmul/Conv -> Activation, Matmul/Conv -> Add (bias or residual), Add -> LayerNorm,
+  // Matmul -> Softmax and Softmax -> Matmul (the probabilities as activations, as in attention).
+  // The tensor must have no other consumer, the same element width on both sides and fit the
+  // buffers of the cores. Adds the pairs to fusion_stats and lists them when `verbose`.
+  std::vector<LayerConfig> fuse_layers(const std::vector<LayerConfig> &configs, int n_cores, bool verbose);
+
+  // Applies the fusion marks of a layer to the jobs built for it
+  void apply_fusion(const LayerConfig &config, const JobPair &jobs);
+}// namespace frontend::standard
+
+#endif//PERF_MODEL_FUSION_H
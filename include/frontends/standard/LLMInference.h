@@ -0,0 +1,46 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PERF_MODEL_LLM_INFERENCE_H
+#define PERF_MODEL_LLM_INFERENCE_H
+
+#include "Job.h"
+#include "frontends/LayerParser.h"
+#include <cstdio>
+
+namespace frontend::standard {
+  struct LLMConfig {
+    int n_layers;
+    int hidden;
+    int heads;
+    int prompt_len;
+    int gen_tokens;
+    int ffn_dim;
+  };
+
+  // Layers of one decoder pass over `tokens` new tokens that attend to `past` cached tokens.
+  // K/V of the new tokens are appended to the cache (KVCacheWrite). The attention matmuls read the
+  // cached K/V from DRAM as their weights, their N/K grow with past + tokens.
+  std::vector<LayerConfig> llm_pass_layers(const LLMConfig &cfg, int tokens, int past);
+
+  // Jobs of one LLMInference layer: a prefill pass over the prompt, then one decode pass per
+  // generated token after the first, each waiting on the previous pass.
+  struct LLMRun {
+    LLMConfig cfg;
+    JobList prefill_roots;
+    std::vector<JobList> pass_sinks;// [0] is the prefill, [i] produces token i
+  };
+
+  extern std::vector<LLMRun> llm_runs;
+
+  // Time-to-first-token and per-token latency of every LLMInference layer that was simulated
+  void report_llm_runs(FILE *f, double ns_per_cycle);
+}// namespace frontend::standard
+
+#endif//PERF_MODEL_LLM_INFERENCE_H
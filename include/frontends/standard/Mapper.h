@@ -0,0 +1,71 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PERF_MODEL_MAPPER_H
+#define PERF_MODEL_MAPPER_H
+
+#include "Job.h"
+#include "frontends/LayerParser.h"
+#include "frontends/standard/StandardArch.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace frontend::standard {
+  struct MapperConfig {
+    bool enabled = false;// -map, GEMM layers are split by the mapper instead of the fixed heuristics
+    int verify_top = 0;  // -map_verify, best candidates of the cost model that are simulated
+  };
+
+  extern MapperConfig mapper_config;
+
+  enum class GemmSplit { N, M, K };
+
+  // One way to split an M x K x N GEMM into systolic array jobs. The rows, the columns or the
+  // reduction dimension are first divided between the cores, every core then covers its block with
+  // m_tile x n_tile jobs. Jobs at the edges of a block take the remainder. With split-K every core
+  // produces partial sums of the whole output, which the vector units add up afterwards, each
+  // reducing one slice of the output across all cores' partials.
+  struct GemmMapping {
+    GemmSplit split = GemmSplit::N;
+    int cores = 1;// cores that get a block, the others stay free for other layers
+    int m_tile = 0;
+    int n_tile = 0;
+    int jobs = 0;       // systolic array jobs
+    int reduce_jobs = 0;// vector unit jobs adding up split-K partial sums
+    uint64_t estimate = 0;// cycles of the cost model
+    uint64_t measured = 0;// cycles of a cycle-accurate run of the layer alone, 0 unless verified
+
+    std::string describe() const;
+  };
+
+  // Every mapping the mapper considers for the GEMM, each with its estimate
+  std::vector<GemmMapping> gemm_candidates(const ArchConfig &a_config, int M, int K, int N);
+
+  // Cost model: cycles until the last core finishes its jobs of the mapping
+  uint64_t estimate_gemm(const ArchConfig &a_config, const GemmMapping &mapping, int M, int K, int N);
+
+  // Bytes a systolic array job streams from its address on, the reads and writes of all of its
+  // tiles. A job's allocation is sized for jobs one array tall, other shapes have to reserve this.
+  int64_t gemm_job_bytes(int64_t m, int64_t k, int64_t n, int sz, bool ws);
+
+  // The jobs of a mapping, pinned to their units and numbered on from the per-unit task counters.
+  // The second list is the reduction of a split-K mapping, else the same as the first.
+  JobPair build_gemm(const ArchConfig &a_config, const GemmMapping &mapping, int M, int K, int N, std::vector<int> &task_counters);
+
+  // Jobs of the best mapping of an M x K x N GEMM layer, after simulating the -map_verify best
+  // candidates when it is set. Prints the choice and the estimate of the fixed split next to it.
+  JobPair map_gemm(const ArchConfig &a_config, const LayerConfig &l_config, int M, int K, int N);
+
+  // Forgets the mappings map_gemm() chose, e.g. when an embedding Simulator drops its model
+  void clear_mappings();
+}// namespace frontend::standard
+
+#endif//PERF_MODEL_MAPPER_H
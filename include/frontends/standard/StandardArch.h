@@ -12,6 +12,13 @@
 
 #include "Arch.h"
 
+namespace SystolicArray {
+  struct SysArrayState;
+}
+namespace VectorUnit {
+  class VecUnitState;
+}
+
 namespace frontend::standard {
   struct ArchConfig {
     int n_cores = -1;
@@ -26,6 +33,14 @@ namespace frontend::standard {
 
   struct StandardArch: Arch {
     StandardArch();
+
+  protected:
+    void increment_units(int begin, int end, StepLane *lane) override;
+
+  private:
+    // The units of `states` by type, in the same order
+    std::vector<SystolicArray::SysArrayState *> sys_arrays;
+    std::vector<VectorUnit::VecUnitState *> vec_units;
   };
 
   extern StandardArch *arch;
@@ -0,0 +1,38 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#ifndef PERF_MODEL_TORCH_LAYER_H
+#define PERF_MODEL_TORCH_LAYER_H
+
+#include "frontends/standard/StandardLayer.h"
+
+namespace frontend::torch {
+  // Reads a torch.fx graph dumped by scripts/export_fx.py and lowers its nodes onto the
+  // standard layer builders. The file is a JSON object with a "nodes" array in topological
+  // order; every node has
+  //   "name"         unique node name, also the name of its output tensor
+  //   "op"           normalized op kind, e.g. linear, matmul, conv2d, softmax, layer_norm, relu, add, view
+  //   "inputs"       names of the nodes whose outputs it reads
+  //   "input_shapes" shape of each tensor input
+  //   "output_shape" shape of the output tensor
+  //   "attrs"        op attributes (kernel_size, stride, padding, out_channels for conv2d),
+  //                  padding may also be "same" or "valid"
+  // Shape-only ops (view, permute, dropout, ...) alias their input instead of creating a layer.
+  // Elementwise ops become an Activation or Add, norms a LayerNorm, any other op is an error.
+  struct FxConfig {
+    bool unknown_as_view = false;// -fx_unknown_as_view, unknown single-input ops cost nothing
+  };
+  extern FxConfig fx_config;
+
+  struct TorchLayer : standard::StandardLayer {
+    std::vector<LayerConfig> read_layers(const std::string &fname) const override;
+  };
+}// namespace frontend::torch
+
+#endif//PERF_MODEL_TORCH_LAYER_H
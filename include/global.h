@@ -14,17 +14,16 @@
 #include <tuple>
 #include <cstdint>
 #include <cstdio>
+#include <string>
 
 #define DSE
 #define DEBUG
 
 struct State;
 
-const int systolic_fpu_latency = 2;
-const int batch_size = 1;
+const int systolic_fpu_latency = 2;// for 2-byte elements, scales with the element width
 const int n_mxus = 4;
 const int n_vpus = 4;
-const int data_type_width = 2;
 const int seq_len = 2048;
 const int dram_enq_per_cycle = 9;
 
@@ -33,24 +32,31 @@ const int buffer_size_bytes = 8 * 1024 * 1024;
 const int embedding_dim= 768;
 const int n_heads = 6;
 
-const int periods = 1;
-const int n_threads = 1;
-
-extern char const * rand_chars[];
+extern int periods;         // -periods, copies of the model enqueued dt cycles apart
+extern int n_threads;       // -threads, copies of the model per period
+extern uint64_t period_dt;  // -dt
+extern int sim_threads;     // -sim_threads, host threads stepping the units
+extern int batch_size;      // -batch
+extern int data_type_width; // -dtype, bytes per element unless a layer sets its own precision
 
 extern std::vector<std::tuple<uint64_t, bool, int, State *>> to_enqueue;
-extern FILE *vcd;
 extern int bytes_per_tx;
 extern int jobs_finished;
 extern int total_jobs;
 extern uint64_t gcycles;
 extern int alloc_task_idx;
+extern int alloc_layer_idx;
+extern int alloc_act_width;   // bytes per activation element of the jobs being built
+extern int alloc_weight_width;// bytes per weight element of the jobs being built
 extern int model_parallelism;
 extern bool do_par;
 extern float freq_sa;
 
 
-int div_ru(int q, int r);
+int64_t div_ru(int64_t q, int64_t r);// ceil(q / r) for q >= 0, r > 0
+
+// Bytes per element of a datatype name (int8, fp8, bf16, fp16, fp32) or of a plain byte count
+int dtype_width(const std::string &name);
 
 
 #endif//PROSE_COMPILER_GLOBAL_H
\ No newline at end of file
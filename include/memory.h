@@ -10,17 +10,25 @@
 #ifndef PROSE_COMPILER_MEMORY_H
 #define PROSE_COMPILER_MEMORY_H
 #include "State.h"
-#include "memory_system.h"
+#include "DRAMSystem.h"
 
 
 namespace mem {
   bool try_enqueue_tx();
-  using mem_ty = dramsim3::JedecDRAMSystem;
+  using mem_ty = ParallelDRAMSystem;
 
   extern dramsim3::Config *dramsim3config;
   extern std::unordered_map<uint64_t, State *> address_reads_bkwds_lookup, address_writes_bkwds_lookup;
   extern mem_ty *mem_sys;
+  extern uint64_t reads_done, writes_done;// completed transactions, for bandwidth counters
+  extern int tick_threads;                 // -dram_threads, host threads ticking the DRAM channels
 
-  void setup();
+  // (Re)creates the DRAM system, a fresh one per run makes repeated runs in one process identical.
+  // The parsed ini is kept and reused by later calls with the same config and output dir.
+  void setup(const std::string &config_file = "../dramsim3/configs/HBM2_8Gb_x128.ini", const std::string &output_dir = "./");
+
+  // Another DRAM system on the config of the last setup(), e.g. for trial runs that must leave
+  // mem_sys untouched. Its completions reach the units the same way.
+  mem_ty *make_system();
 };// namespace mem
 #endif//PROSE_COMPILER_MEMORY_H
@@ -13,7 +13,8 @@
 
 static const int WIDTH_STATE = 3;
 static const int WIDTH_IDLE_FROM_MEMORY = 1;
-static const int WIDTH_JOB_IDX = 8;
+static const int WIDTH_JOB_IDX = 32;
+static const int WIDTH_PHASE = 32;// -serve and -periods runs have a phase per arrival
 static const int WIDTHS[] = {WIDTH_STATE, WIDTH_IDLE_FROM_MEMORY, WIDTH_JOB_IDX};
 
 static const int STAT_STATE = 0;
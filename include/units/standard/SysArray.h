@@ -19,6 +19,7 @@ namespace SystolicArray {
       return SYSTOLIC_ARRAY_IDX;
     }
     int M, K, N;
+    bool act_prebuffered = false;// activations arrive through the on-chip buffer, only weights are read
 
     SysArrayJob(int m, int k, int n);
 
@@ -33,7 +34,7 @@ namespace SystolicArray {
     write
   };
 
-  struct SysArrayState : State {
+  struct SysArrayState final : State {
 public:
     explicit SysArrayState(int sz, bool ws);
     bool ws = false;// Flag for weight-stationary systolic array
@@ -43,8 +44,7 @@ public:
     int sz;
     ExState state = idle;
 
-    bool increment(const std::function<void(Job *)> &enqueue_job,
-                   int &total_idle,
+    bool increment(int &total_idle,
                    int *n_idle_units) override;
 
     void set_state(int st) override {
@@ -54,6 +54,11 @@ public:
     int get_state() override {
       return state;
     }
+
+    std::string get_state_string(int st) override {
+      static const char *names[] = {"idle", "prefetch", "read", "shift", "write"};
+      return names[st];
+    }
     
 
     int get_ty_idx() override {
@@ -63,8 +68,16 @@ public:
       return SYSTOLIC_ARRAY_STRING;
     }
 
+    void save(std::ostream &out) override;
+    void load(std::istream &in) override;
+
 private:
     int beats_per_wb;
+    int fpu_latency = systolic_fpu_latency;// cycles per MAC stage at the job's element width
+
+    // increment() for one dataflow, so the OS/WS choice is made once per call
+    template<bool WS>
+    bool step(int &total_idle, int *n_idle_units);
   };
 
 };// namespace SystolicArray
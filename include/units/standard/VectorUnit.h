@@ -29,7 +29,7 @@ namespace VectorUnit {
     BROADCAST
   };
 
-  class VecUnitState : public State {
+  class VecUnitState final : public State {
 public:
     explicit VecUnitState(int sz);
 
@@ -37,8 +37,7 @@ public:
     int sz;
     VectorUnit::VPUState state = VectorUnit::idle;
 
-    bool increment(const std::function<void(Job *)> &enqueue_job,
-                   int &total_idle,
+    bool increment(int &total_idle,
                    int *n_idle_units) override;
 
     void set_state(int st) override {
@@ -48,6 +47,11 @@ public:
       return (int) state;
     }
 
+    std::string get_state_string(int st) override {
+      static const char *names[] = {"idle", "unbuffered_lin", "unbuffered_par", "buffered_lin", "buffered_par", "write"};
+      return names[st];
+    }
+
     int get_ty_idx() override {
       return VECTOR_UNIT_IDX;
     }
@@ -65,15 +69,23 @@ private:
   struct VecUnitJob : public Job {
     int linearized_dimension;
     int parallel_dimension;
-    std::queue<std::pair<VPUPhase, int>> phases;
+    std::queue<std::pair<VPUPhase, int>> phases;// consumed while the job runs
+    std::queue<std::pair<VPUPhase, int>> phases_hold;
     bool is_prebuffered;
     int op_latency = 1;
+    int n_operands = 1;       // input tensors streamed in when not prebuffered
 
     [[nodiscard]] std::string get_job_dims_string() const override;
     VecUnitJob(int linearizedDimension, int parallelDimension, bool is_prebuffered, const std::queue<std::pair<VPUPhase, int>> &phases);
     VecUnitJob(int linearizedDimension, int parallelDimension, bool is_prebuffered, const std::vector<std::pair<VPUPhase, int>> &phases);
 
     int get_type() const override;
+    void reset() override {
+      Job::reset();
+      phases = phases_hold;
+    }
+    void save(std::ostream &out) const override;
+    void load(std::istream &in) override;
   };
 
 };// namespace VectorUnit
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+
+# COCOSSim in-process Python binding
+# Copyright (c) 2025 APEX Lab, Duke University
+#
+# ctypes wrapper over the C ABI in include/cocossim.h. Point COCOSSIM_LIB at libcocossim.so, or pass
+# its path to Simulator. DRAMSim3 config paths are resolved against the working directory.
+#
+#   from cocossim import Simulator
+#   sim = Simulator(cores=2, sa_sz=64, vu_sz=64, batch_size=4, map=True, lib="build/libcocossim.so")
+#   sim.add_layers("Matmul 256 256 256")
+#   stats = sim.run()
+#   print(stats["cycles"], stats["units"][0])
+
+import ctypes
+import os
+
+
+class _Stats(ctypes.Structure):
+    _fields_ = [("cycles", ctypes.c_uint64), ("time_us", ctypes.c_double), ("jobs", ctypes.c_int),
+                ("dram_reads", ctypes.c_uint64), ("dram_writes", ctypes.c_uint64),
+                ("n_units", ctypes.c_int), ("n_layers", ctypes.c_int)]
+
+
+class _UnitStats(ctypes.Structure):
+    _fields_ = [(name, ctypes.c_uint64) for name in
+                ("active", "compute", "read_stall", "write_stall", "dep_wait", "idle")]
+
+
+class _LayerStats(ctypes.Structure):
+    _fields_ = [("jobs", ctypes.c_int)] + [(name, ctypes.c_uint64) for name in
+                                           ("start", "finish", "read_stall", "write_stall", "bytes_read",
+                                            "bytes_written")]
+
+
+class _Options(ctypes.Structure):
+    _fields_ = [("cores", ctypes.c_int), ("sa_sz", ctypes.c_int), ("vu_sz", ctypes.c_int), ("ws", ctypes.c_int),
+                ("freq_ghz", ctypes.c_double), ("batch_size", ctypes.c_int), ("dtype_width", ctypes.c_int),
+                ("map", ctypes.c_int), ("map_verify", ctypes.c_int), ("fuse", ctypes.c_int),
+                ("dram_config", ctypes.c_char_p), ("dram_output_dir", ctypes.c_char_p)]
+
+
+def _load(path):
+    lib = ctypes.CDLL(path or os.environ.get("COCOSSIM_LIB", "libcocossim.so"))
+    p = ctypes.c_void_p
+    lib.cocossim_default_options.argtypes = [ctypes.POINTER(_Options)]
+    lib.cocossim_create_with.restype = p
+    lib.cocossim_create_with.argtypes = [ctypes.POINTER(_Options)]
+    lib.cocossim_destroy.argtypes = [p]
+    lib.cocossim_load_model.argtypes = [p, ctypes.c_char_p]
+    lib.cocossim_add_layers.argtypes = [p, ctypes.c_char_p]
+    lib.cocossim_clear_model.argtypes = [p]
+    lib.cocossim_run.argtypes = [p, ctypes.POINTER(_Stats)]
+    lib.cocossim_get_unit_stats.argtypes = [p, ctypes.c_int, ctypes.POINTER(_UnitStats)]
+    lib.cocossim_unit_name.argtypes = [p, ctypes.c_int]
+    lib.cocossim_unit_name.restype = ctypes.c_char_p
+    lib.cocossim_get_layer_stats.argtypes = [p, ctypes.c_int, ctypes.POINTER(_LayerStats)]
+    lib.cocossim_layer_name.argtypes = [p, ctypes.c_int]
+    lib.cocossim_layer_name.restype = ctypes.c_char_p
+    lib.cocossim_last_error.restype = ctypes.c_char_p
+    return lib
+
+
+def _fields(struct):
+    return {name: getattr(struct, name) for name, _ in struct._fields_}
+
+
+class Simulator:
+    # dtype_width is in bytes per element, map_verify > 0 turns the mapper on like map
+    def __init__(self, cores=1, sa_sz=64, vu_sz=64, ws=False, freq_ghz=1.0, batch_size=1, dtype_width=2, map=False,
+                 map_verify=0, fuse=False, dram_config=None, dram_output_dir=None, lib=None):
+        self._lib = _load(lib)
+        opts = _Options()
+        self._lib.cocossim_default_options(ctypes.byref(opts))
+        for name, value in (("cores", cores), ("sa_sz", sa_sz), ("vu_sz", vu_sz), ("ws", int(ws)),
+                            ("freq_ghz", freq_ghz), ("batch_size", batch_size), ("dtype_width", dtype_width),
+                            ("map", int(map)), ("map_verify", map_verify), ("fuse", int(fuse))):
+            setattr(opts, name, value)
+        opts.dram_config = dram_config.encode() if dram_config else None
+        opts.dram_output_dir = dram_output_dir.encode() if dram_output_dir else None
+        self._sim = self._lib.cocossim_create_with(ctypes.byref(opts))
+        if not self._sim:
+            self._fail()
+
+    def _fail(self):
+        raise RuntimeError(self._lib.cocossim_last_error().decode())
+
+    def _check(self, rc):
+        if rc != 0:
+            self._fail()
+
+    def load_model(self, fname):
+        self._check(self._lib.cocossim_load_model(self._sim, fname.encode()))
+
+    def add_layers(self, text):
+        self._check(self._lib.cocossim_add_layers(self._sim, text.encode()))
+
+    def clear_model(self):
+        self._lib.cocossim_clear_model(self._sim)
+
+    def run(self):
+        stats = _Stats()
+        self._check(self._lib.cocossim_run(self._sim, ctypes.byref(stats)))
+        out = _fields(stats)
+        out["units"], out["layers"] = [], []
+        for i in range(stats.n_units):
+            u = _UnitStats()
+            self._check(self._lib.cocossim_get_unit_stats(self._sim, i, ctypes.byref(u)))
+            out["units"].append({"name": self._lib.cocossim_unit_name(self._sim, i).decode(), **_fields(u)})
+        for i in range(stats.n_layers):
+            l = _LayerStats()
+            self._check(self._lib.cocossim_get_layer_stats(self._sim, i, ctypes.byref(l)))
+            out["layers"].append({"name": self._lib.cocossim_layer_name(self._sim, i).decode(), **_fields(l)})
+        return out
+
+    def close(self):
+        if getattr(self, "_sim", None):
+            self._lib.cocossim_destroy(self._sim)
+            self._sim = None
+
+    def __del__(self):
+        self.close()
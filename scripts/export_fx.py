@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+
+# COCOSSim torch.fx graph exporter
+# Copyright (c) 2025 APEX Lab, Duke University
+#
+# Traces a PyTorch module with torch.fx, propagates shapes for an example input and
+# writes the JSON graph read by frontend::torch::TorchLayer (any -i file ending in .json).
+#
+# Library use:
+#   from export_fx import export
+#   export(model, (torch.randn(1, 128, 768),), "model.json")
+#
+# Command line use (module must be importable and constructible without arguments):
+#   python3 scripts/export_fx.py torchvision.models:resnet18 --input-shape 1,3,224,224 -o resnet18.json
+
+import argparse
+import importlib
+import json
+
+import torch
+import torch.fx
+from torch.fx.passes.shape_prop import ShapeProp
+
+# nn.Module types and their op kind in the exported graph
+MODULE_OPS = {
+    torch.nn.Linear: "linear",
+    torch.nn.Conv2d: "conv2d",
+    torch.nn.LayerNorm: "layer_norm",
+    torch.nn.GroupNorm: "group_norm",
+    torch.nn.BatchNorm2d: "batch_norm",
+    torch.nn.BatchNorm1d: "batch_norm",
+    torch.nn.Softmax: "softmax",
+    torch.nn.LogSoftmax: "log_softmax",
+    torch.nn.ReLU: "relu",
+    torch.nn.ReLU6: "relu6",
+    torch.nn.GELU: "gelu",
+    torch.nn.SiLU: "silu",
+    torch.nn.Sigmoid: "sigmoid",
+    torch.nn.Tanh: "tanh",
+    torch.nn.Hardswish: "hardswish",
+    torch.nn.Dropout: "dropout",
+    torch.nn.Identity: "identity",
+    torch.nn.Flatten: "flatten",
+}
+
+# torch function / method names that differ from the op kind
+FUNCTION_ALIASES = {
+    "scaled_dot_product_attention": "sdpa",
+    "__add__": "add",
+    "__iadd__": "iadd",
+    "__mul__": "mul",
+    "__sub__": "sub",
+    "__truediv__": "div",
+    "__getitem__": "getitem",
+}
+
+
+def _shape(node):
+    meta = node.meta.get("tensor_meta")
+    if meta is None or not hasattr(meta, "shape"):
+        return None
+    return [int(d) for d in meta.shape]
+
+
+def _op_kind(gm, node):
+    if node.op in ("placeholder", "get_attr", "output"):
+        return node.op
+    if node.op == "call_module":
+        mod = gm.get_submodule(node.target)
+        for ty, kind in MODULE_OPS.items():
+            if isinstance(mod, ty):
+                return kind
+        return type(mod).__name__.lower()
+    name = node.target if isinstance(node.target, str) else getattr(node.target, "__name__", str(node.target))
+    return FUNCTION_ALIASES.get(name, name)
+
+
+def _attrs(gm, node, kind):
+    if node.op == "call_module" and kind == "conv2d":
+        mod = gm.get_submodule(node.target)
+        return {"out_channels": mod.out_channels, "kernel_size": list(mod.kernel_size),
+                "stride": list(mod.stride),
+                "padding": mod.padding if isinstance(mod.padding, str) else list(mod.padding)}
+    if node.op == "call_function" and kind == "conv2d":
+        weight = node.args[1]
+        args = {"stride": 1, "padding": 0}
+        args.update({k: v for k, v in zip(("bias", "stride", "padding"), node.args[2:5])})
+        args.update(node.kwargs)
+        out = {"stride": args["stride"], "padding": args["padding"]}
+        wshape = _shape(weight) if isinstance(weight, torch.fx.Node) else None
+        if wshape:
+            out["out_channels"] = wshape[0]
+            out["kernel_size"] = wshape[2:]
+        return out
+    return {}
+
+
+def export(model, example_inputs, path):
+    gm = torch.fx.symbolic_trace(model)
+    ShapeProp(gm).propagate(*example_inputs)
+
+    nodes = []
+    for node in gm.graph.nodes:
+        kind = _op_kind(gm, node)
+        inputs = [a for a in node.all_input_nodes]
+        nodes.append({
+            "name": node.name,
+            "op": kind,
+            "inputs": [a.name for a in inputs],
+            "input_shapes": [_shape(a) for a in inputs if _shape(a) is not None],
+            "output_shape": _shape(node),
+            "attrs": _attrs(gm, node, kind),
+        })
+
+    with open(path, "w") as f:
+        json.dump({"format": "cocossim-fx", "version": 1, "nodes": nodes}, f, indent=1)
+    return nodes
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Export a PyTorch module as a COCOSSim graph")
+    parser.add_argument("module", help="module path and constructor, e.g. torchvision.models:resnet18")
+    parser.add_argument("--input-shape", action="append", required=True,
+                        help="comma separated shape of an example input, repeat for several inputs")
+    parser.add_argument("-o", "--output", required=True)
+    args = parser.parse_args()
+
+    mod_name, ctor = args.module.split(":")
+    model = getattr(importlib.import_module(mod_name), ctor)().eval()
+    inputs = tuple(torch.randn(*[int(d) for d in s.split(",")]) for s in args.input_shape)
+    nodes = export(model, inputs, args.output)
+    print(f"Wrote {len(nodes)} nodes to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+
+# COCOSSim simulator throughput benchmark
+# Copyright (c) 2025 APEX Lab, Duke University
+#
+# Runs the fixed workload set in bench/suite.json and, per case, records host time, simulated
+# cycles per host second and peak RSS. Every run is checked against two stored files:
+#   - bench/golden_cycles.json: the simulated cycle counts must match exactly, otherwise the case
+#     FAILs. They do not depend on the host and belong in the tree. Without the file the cycle check
+#     is skipped with a note, until someone with the real DRAMSim3 records it.
+#   - bench/baseline.json: host time beyond the tolerance is reported as a SLOWDOWN. It depends on
+#     the host, so record it on the machine the comparison runs on. Without one only cycles are checked.
+# Either makes the script exit with status 1.
+#
+#   python3 scripts/perf_bench.py --binary build/perf_model                     # compare
+#   python3 scripts/perf_bench.py --binary build/perf_model --update-baseline   # record host times
+#   python3 scripts/perf_bench.py --binary build/perf_model --update-golden     # record cycle counts
+#
+# Record golden cycles only when a change is meant to alter the simulated timing.
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def run_case(binary, common_args, case):
+    with tempfile.NamedTemporaryFile(suffix=".txt", delete=False) as out:
+        out_path = out.name
+    cmd = [binary] + common_args + case["args"] + ["-i", os.path.join(REPO, case["workload"]), "-o", out_path]
+    try:
+        # stderr goes to a file, a pipe nobody reads until the exit would block a chatty run
+        with tempfile.TemporaryFile() as err_file:
+            start = time.perf_counter()
+            # The simulator finds ../dramsim3/configs relative to its working directory
+            proc = subprocess.Popen(cmd, cwd=os.path.dirname(binary), stdout=subprocess.DEVNULL, stderr=err_file)
+            _, status, usage = os.wait4(proc.pid, 0)
+            host_s = time.perf_counter() - start
+            proc.returncode = os.waitstatus_to_exitcode(status)
+            err_file.seek(0)
+            err = err_file.read().decode(errors="replace")
+        if proc.returncode != 0:
+            raise RuntimeError(f"{case['name']}: exited with {proc.returncode}\n{err}")
+        with open(out_path) as f:
+            cycles = [int(m.group(1)) for m in re.finditer(r"^Cycles (\d+)$", f.read(), re.M)]
+    finally:
+        os.unlink(out_path)
+    if not cycles:
+        raise RuntimeError(f"{case['name']}: no Cycles line in the output file")
+    # ru_maxrss is in KiB on Linux
+    return {"host_s": host_s, "cycles": cycles, "sim_cycles_per_s": sum(cycles) / host_s,
+            "peak_rss_mb": usage.ru_maxrss / 1024.0}
+
+
+def write_cases(path, cases, merge):
+    # A filtered run only replaces the cases it ran
+    if merge and os.path.exists(path):
+        with open(path) as f:
+            cases = {**json.load(f)["cases"], **cases}
+    with open(path, "w") as f:
+        json.dump({"cases": cases}, f, indent=2, sort_keys=True)
+        f.write("\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="COCOSSim throughput benchmark and regression check")
+    parser.add_argument("--binary", default=os.path.join(REPO, "build", "perf_model"))
+    parser.add_argument("--suite", default=os.path.join(REPO, "bench", "suite.json"))
+    parser.add_argument("--baseline", default=os.path.join(REPO, "bench", "baseline.json"))
+    parser.add_argument("--golden", default=os.path.join(REPO, "bench", "golden_cycles.json"))
+    parser.add_argument("--update-baseline", action="store_true", help="record this run's host times as the baseline")
+    parser.add_argument("--update-golden", action="store_true", help="record this run's cycle counts as golden")
+    parser.add_argument("--tolerance", type=float, default=0.10, help="allowed host time increase (0.10 = 10%%)")
+    parser.add_argument("--repeat", type=int, default=1, help="runs per case, the fastest one counts")
+    parser.add_argument("--filter", default="", help="only run cases whose name contains this string")
+    args = parser.parse_args()
+
+    binary = os.path.abspath(args.binary)
+    with open(args.suite) as f:
+        suite = json.load(f)
+    recording = args.update_baseline or args.update_golden
+    baseline, golden = {}, {}
+    if not recording:
+        if os.path.exists(args.golden):
+            with open(args.golden) as f:
+                golden = json.load(f)["cases"]
+        else:
+            golden = None
+            print(f"No golden cycles at {args.golden}, SKIPPING the cycle check (record them with --update-golden)")
+        if os.path.exists(args.baseline):
+            with open(args.baseline) as f:
+                baseline = json.load(f)["cases"]
+        else:
+            print(f"No baseline at {args.baseline}, host times are not compared (record one with --update-baseline)")
+
+    results = {}
+    failed = False
+    print(f"{'case':<32} {'host s':>9} {'Mcyc/s':>9} {'RSS MB':>8} {'vs base':>8}  status")
+    for case in suite["cases"]:
+        if args.filter not in case["name"]:
+            continue
+        runs = [run_case(binary, suite["common_args"], case) for _ in range(max(1, args.repeat))]
+        res = min(runs, key=lambda r: r["host_s"])
+        results[case["name"]] = res
+
+        delta, status = "", "ok"
+        base = baseline.get(case["name"])
+        gold = golden.get(case["name"]) if golden is not None else None
+        if base is not None:
+            ratio = res["host_s"] / base["host_s"] - 1.0
+            delta = f"{ratio * 100:+.1f}%"
+        if recording:
+            status = "recorded"
+        elif golden is not None and gold is None:
+            status = "FAIL no golden cycles"
+            failed = True
+        elif gold is not None and res["cycles"] != gold:
+            status = f"FAIL cycles {res['cycles']} != golden {gold}"
+            failed = True
+        elif base is None:
+            status = "ok, no baseline" if gold is not None else "ok, no golden or baseline"
+        elif ratio > args.tolerance:
+            status = "SLOWDOWN"
+            failed = True
+        elif gold is None:
+            status = "ok, no golden"
+        print(f"{case['name']:<32} {res['host_s']:>9.3f} {res['sim_cycles_per_s'] / 1e6:>9.3f} "
+              f"{res['peak_rss_mb']:>8.1f} {delta:>8}  {status}", flush=True)
+
+    if args.update_baseline:
+        host = {name: {k: v for k, v in r.items() if k != "cycles"} for name, r in results.items()}
+        write_cases(args.baseline, host, args.filter)
+        print(f"Baseline written to {args.baseline}")
+    if args.update_golden:
+        write_cases(args.golden, {name: r["cycles"] for name, r in results.items()}, args.filter)
+        print(f"Golden cycles written to {args.golden}")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -10,12 +10,15 @@
 #include "Arch.h"
 #include "memory.h"
 #include "perf_enums.h"
+#include "Profiler.h"
 #include "State.h"
+#include "Trace.h"
+#include "WhatIf.h"
+#include <algorithm>
 #include <set>
+#include <sstream>
 #include <unordered_map>
 
-std::unordered_map<int, int> state_updates;
-
 State *Arch::have_idle_type(int ty) {
   for (auto &state: states) {
     if (state->get_ty_idx() == ty && state->get_state() == 0) {
@@ -25,32 +28,189 @@ State *Arch::have_idle_type(int ty) {
   return nullptr;
 }
 
+Arch::~Arch() {
+  for (auto *state: states) delete state;
+}
+
+void Arch::enqueue_job(Job *job) {
+  job->ready_cycle = gcycles;
+  if (!unpinned && job->core_id >= 0 && job->core_id < states.size()) {
+    core_queues[job->core_id].push_back(job);// Specific core requested
+  } else {
+    // core_id == -1: pick the least loaded unit of the matching type so independent
+    // branches of the graph spread across cores
+    int best_core = -1;
+    size_t best_load = 0;
+    for (int core_idx = 0; core_idx < states.size(); ++core_idx) {
+      if (states[core_idx]->get_ty_idx() == job->get_type()) {
+        size_t load = core_queues[core_idx].size() + (states[core_idx]->get_state() != 0 || finishing[core_idx]);
+        if (best_core < 0 || load < best_load) {
+          best_core = core_idx;
+          best_load = load;
+        }
+      }
+    }
+    if (best_core < 0) {
+      // Fallback: assign to first core (shouldn't happen if architecture is correct)
+      best_core = 0;
+    }
+    core_queues[best_core].push_back(job);
+  }
+  total_frontier += 1;
+}
+
+void Arch::finish_job(Job *job) {
+  jobs_finished++;
+  for (auto *child: job->children) {
+    child->rem_deps -= 1;
+    if (child->rem_deps == 0) {
+      IFVERB(std::cout << "enqueuing child " << std::endl);
+      enqueue_job(child);
+    }
+  }
+}
+
+void Arch::increment_units(int begin, int end, StepLane *lane) {
+  for (int i = begin; i < end; ++i) increment_unit(i, states[i], lane);
+}
+
+void Arch::start_lanes(int n_types) {
+  finishing.assign(states.size(), 0);
+  step_lanes.clear();
+  step_pool.reset();
+  int n = std::min<int>(sim_threads, (int) states.size());
+  // Waveform changes are written in the order the units make them
+  if (n > 1 && !waveform) {
+    step_pool.reset(new LockstepPool(n));
+    if (step_pool->size() < n) {
+      std::cerr << "Warning: -sim_threads " << n << " capped to " << step_pool->size() << " threads, the host cores left" << std::endl;
+    }
+  }
+  if (!step_pool || step_pool->size() == 1) {
+    step_pool.reset();
+    for (auto *state: states) state->tx_queue = &to_enqueue;
+    return;
+  }
+  step_lanes.resize(step_pool->size());
+  for (int t = 0; t < step_lanes.size(); ++t) {
+    auto &lane = step_lanes[t];
+    lane.begin = (int) (states.size() * t / step_lanes.size());
+    lane.end = (int) (states.size() * (t + 1) / step_lanes.size());
+    lane.n_idle_units.assign(n_types, 0);
+    for (int i = lane.begin; i < lane.end; ++i) states[i]->tx_queue = &lane.transactions;
+  }
+}
+
+void Arch::stop_lanes() {
+  step_pool.reset();
+  step_lanes.clear();
+  for (auto *state: states) state->tx_queue = &to_enqueue;
+}
+
+void Arch::step_units() {
+  if (!step_pool) return increment_units(0, (int) states.size(), nullptr);
+  // A few busy units are not worth waking the other threads for, the lanes merge the same either way
+  const int min_busy_per_lane = 4;
+  if ((int) states.size() - total_idle < min_busy_per_lane * (int) step_lanes.size()) {
+    for (auto &lane: step_lanes) increment_units(lane.begin, lane.end, &lane);
+  } else {
+    auto step = [this](int t) { increment_units(step_lanes[t].begin, step_lanes[t].end, &step_lanes[t]); };
+    step_pool->run(step);
+  }
+  merge_lanes();
+}
+
+void Arch::merge_lanes() {
+  for (auto &lane: step_lanes) {
+    total_idle += lane.total_idle;
+    lane.total_idle = 0;
+    for (int ty = 0; ty < lane.n_idle_units.size(); ++ty) {
+      n_idle_units[ty] += lane.n_idle_units[ty];
+      lane.n_idle_units[ty] = 0;
+    }
+    to_enqueue.insert(to_enqueue.end(), lane.transactions.begin(), lane.transactions.end());
+    lane.transactions.clear();
+    for (Job *job: lane.finished) finishing[job->unit_idx] = 1;
+  }
+  // A serial step releases children between units, so units finishing later in the cycle still
+  // look busy to enqueue_job()
+  for (auto &lane: step_lanes) {
+    for (Job *job: lane.finished) {
+      finishing[job->unit_idx] = 0;
+      finish_job(job);
+    }
+    lane.finished.clear();
+  }
+}
+
+void Arch::skip_stage(int i, State *unit) {
+  // Memory callbacks and ideal compute change a stage from outside, only pure countdowns are skipped
+  if (unit->mem_read_left > 0 || unit->mem_write_left > 0 || unit->is_idle_from_memory ||
+      whatif_config.ideal_compute) {
+    return;
+  }
+  uint64_t n = unit->min_stage_cycles - 1;
+  unit->min_stage_cycles = 1;
+  skip_from[i] = gcycles + 1;
+  resume_at[i] = gcycles + 1 + n;
+}
+
+void Arch::credit_skipped(int i, uint64_t end) {
+  uint64_t n = std::min(end, resume_at[i]) - skip_from[i];
+  per_array_act[i] += n;
+  active_cycles[i] += n;
+  unit_breakdown[i].compute += n;
+  skip_from[i] += n;
+}
+
+void Arch::credit_all_skipped() {
+  for (int i = 0; i < states.size(); ++i) {
+    if (skip_from[i] < resume_at[i] && skip_from[i] <= gcycles) credit_skipped(i, gcycles + 1);
+  }
+}
+
+void Arch::wake_units() {
+  // A skipped stage is stepped again from the next cycle, with the compute cycles it had left
+  uint64_t next = gcycles + 1;
+  for (int i = 0; i < states.size(); ++i) {
+    if (resume_at[i] == never || resume_at[i] <= next) continue;
+    credit_skipped(i, next);
+    states[i]->min_stage_cycles = resume_at[i] - next + 1;
+    resume_at[i] = skip_from[i] = next;
+  }
+}
+
+void Arch::unit_idled(int i) {
+  resume_at[i] = skip_from[i] = never;
+  idle_from[i] = gcycles;
+  idle_mark[i] = machine_idle;
+}
+
+void Arch::credit_idle(int i) {
+  // A cycle without a job is idle if the whole machine was, and waiting on dependencies otherwise
+  uint64_t n = gcycles + 1 - idle_from[i];
+  uint64_t idle = machine_idle - idle_mark[i];
+  unit_breakdown[i].idle += idle;
+  unit_breakdown[i].dep_wait += n - idle;
+  idle_from[i] = gcycles + 1;
+  idle_mark[i] = machine_idle;
+}
+
 void Arch::init_waveforms() {
-#ifdef VCD
-#define dec(nm) fprintf(vcd, "$var wire %d %s %s_%d_%s $end\n", \
-  WIDTH_ ##nm, \
-  rand_chars[((vcd_idx << total_stat_bits) | (STAT_ ##nm ))], \
-  state->get_ty_string().c_str(), vcd_idx, #nm);
-
-  fprintf(vcd, "$timescale 1ns $end\n");
-  fprintf(vcd, "$scope module top $end\n");
-  fprintf(vcd, "$var wire 8 ? phase $end\n");
+  if (!waveform) return;
+#define dec(nm) waveform->declare(STAT_ID(nm, vcd_idx), \
+  state->get_ty_string() + "_" + std::to_string(vcd_idx) + "_" #nm, WIDTH_ ##nm);
+
+  waveform->declare(PHASE_STATE_IDX, "phase", WIDTH_PHASE);
   for (int vcd_idx = 0; vcd_idx < states.size(); vcd_idx++) {
+    if (!waveform_config.keeps_unit(vcd_idx)) continue;
     auto &state = states.at(vcd_idx);
     dec(STATE);
     dec(IDLE_FROM_MEMORY);
     dec(JOB_IDX);
   }
-
-  fprintf(vcd, "$upscope $end\n");
-  fprintf(vcd, "$enddefinitions $end\n");
-  fprintf(vcd, "$dumpvars\n");
-  fprintf(vcd, "b00000000 ?\n");
-  for (int i = 0; i < states.size(); ++i) {
-    fprintf(vcd, "b%s %s\n", int_to_binary(0, 3).c_str(), rand_chars[(i << total_stat_bits) | STAT_STATE]);
-  }
-  fprintf(vcd, "$end\n");
-#endif
+#undef dec
+  waveform->begin();
 }
 
 
@@ -65,50 +225,35 @@ RuntimeStats_t *Arch::get_cycles(TimeBasedEnqueue &time_enqueues) {
     }
     n_types = (int) a.size();
   }
+  run.n_types = n_types;
   
   n_idle_units = new int[n_types];
   memset(n_idle_units, 0, sizeof(int) * n_types);
   // Per-core job queues enable true parallel execution
-  std::vector<std::vector<Job *>> core_queues(states.size());
-  
-  std::function<void(Job *)> enqueue_job = [&](Job *job) -> void {
-    if (job->core_id >= 0 && job->core_id < states.size()) {
-    core_queues[job->core_id].push_back(job);     // Specific core requested
-    } else {
-      // core_id == -1: Find ANY available core of the matching type
-      bool assigned = false;
-      for (int core_idx = 0; core_idx < states.size(); ++core_idx) {
-        if (states[core_idx]->get_ty_idx() == job->get_type()) {
-          core_queues[core_idx].push_back(job);
-          assigned = true;
-          break;
-        }
-      }
-      if (!assigned) {
-        // Fallback: assign to first core (shouldn't happen if architecture is correct)
-        core_queues[0].push_back(job);
-      }
-    }
-    total_frontier += 1;
-  };
-
+  core_queues.assign(states.size(), {});
+  start_lanes(n_types);
+  // The cycle hook takes enqueue_job() as a callable
+  enqueue_job_f_t enqueue_fn = [this](Job *job) { enqueue_job(job); };
 
   if (time_enqueues.time_points.empty()) return nullptr;
   if (time_enqueues.time_points[0] != 0) {
     throw std::runtime_error("First time point must be 0");
   }
-  auto *stats = new RuntimeStats_t[time_enqueues.to_enqueue.size()];
+  auto *stats = run.stats = new RuntimeStats_t[time_enqueues.to_enqueue.size()];
   auto total_states = states.size();
   for (int i = 0; i < time_enqueues.to_enqueue.size(); ++i) {
     stats[i].pct_active = new double[total_states];
   }
 
-  uint64_t phase_cycles = 0;
+  run.enqueues = &time_enqueues;
+  auto &phase_cycles = run.phase_cycles;
+  phase_cycles = 0;
   gcycles = 0;
   const uint64_t MAX_TIME = 0xFFFFFFFFFFFFFFFF;
 
-  int phase_idx = 0;
-  uint64_t next_phase;
+  auto &phase_idx = run.phase_idx;
+  phase_idx = 0;
+  auto &next_phase = run.next_phase;
   if (time_enqueues.time_points.size() > 1) {
     next_phase = time_enqueues.time_points[1];
   } else {
@@ -122,18 +267,27 @@ RuntimeStats_t *Arch::get_cycles(TimeBasedEnqueue &time_enqueues) {
     enqueue_job(i);
   }
 
-  int dram_cmds = 0;
+  auto &dram_cmds = run.dram_cmds;
+  dram_cmds = 0;
 
   for (auto state: states) {
     n_idle_units[state->get_ty_idx()] += 1;
     total_idle += 1;
   }
 
-  int logged_job_count = -1;
+  prof::ProgressReporter progress;
 
 
-  auto *per_array_act = new uint64_t[states.size()];
+  per_array_act = new uint64_t[states.size()];
   memset(per_array_act, 0, sizeof(uint64_t) * (states.size()));
+  active_cycles.assign(states.size(), 0);
+  unit_breakdown.assign(states.size(), UnitBreakdown());
+  resume_at.assign(states.size(), never);
+  skip_from.assign(states.size(), never);
+  idle_from.assign(states.size(), gcycles + 1);
+  idle_mark.assign(states.size(), 0);
+  machine_idle = 0;
+  dispatched_jobs.clear();
 
 
   std::function<void(int)> write_stats = [&](int phase_idx) -> void {
@@ -143,15 +297,56 @@ RuntimeStats_t *Arch::get_cycles(TimeBasedEnqueue &time_enqueues) {
     }
   };
 
-  double diff_accumulator_mem = 0;
+  auto &diff_accumulator_mem = run.diff_accumulator_mem;
+  diff_accumulator_mem = 0;
   const double mem_slow_factor = 1;
   const double differential_mem = mem::dramsim3config->tCK / freq_sa / mem_slow_factor;
   const double cycle_adjust = 1. / freq_sa;
 
-  while (!(total_idle == states.size() && total_frontier == 0)) {
+  run.jobs.clear();
+  run.job_ids.clear();
+  if (checkpoint_hook || restore_hook) {
+    JobList roots;
+    for (auto *jobs: time_enqueues.to_enqueue) roots.insert(roots.end(), jobs->begin(), jobs->end());
+    run.jobs = collect_jobs(roots);
+    for (int i = 0; i < run.jobs.size(); ++i) run.job_ids[run.jobs[i]] = i;
+  }
+  if (restore_hook) restore_hook();
+
+  bool hook_active = (bool) cycle_hook;
+  bool checkpoint_late = false;
+
+  // Keep going while units are busy, jobs are queued or later time points still have to be enqueued
+  while (!(total_idle == states.size() && total_frontier == 0) || next_phase != MAX_TIME || hook_active) {
+    if (gcycles >= fork_cycle) {
+      fork_cycle = MAX_TIME;
+      fork_hook();
+      wake_units();// a branch may run under settings the skipped stages were not planned for
+    }
+    if (gcycles >= checkpoint_cycle) {
+      // Waits for DRAM to go quiet on its own, holding requests back would change the run's timing
+      if (mem::address_reads_bkwds_lookup.empty() && mem::address_writes_bkwds_lookup.empty()) {
+        checkpoint_hook();
+        checkpoint_late = false;
+      } else if (!checkpoint_late && gcycles - checkpoint_cycle >= checkpoint_warn_after) {
+        checkpoint_late = true;
+        std::cerr << "Warning: checkpoint due at cycle " << checkpoint_cycle << " still waits for DRAM to go idle at cycle "
+                  << gcycles << std::endl;
+      }
+    }
+    if (cycle_hook) {
+      credit_all_skipped();// hooks may read the per-unit counters
+      hook_active = cycle_hook(enqueue_fn);
+    }
+    if (total_idle == states.size() && total_frontier == 0 && !hook_active && next_phase != MAX_TIME && gcycles < next_phase) {
+      // Nothing in flight until the next time point: skip the idle gap instead of ticking through it
+      phase_cycles += next_phase - gcycles;
+      machine_idle += next_phase - gcycles;
+      gcycles = next_phase;
+    }
     if (gcycles >= next_phase) {
       phase_idx++;
-      state_updates.at(-1) = -1;
+      LOG_TO_WAVEFORM(PHASE_STATE_IDX, phase_idx);
       for (auto *job: *(time_enqueues.to_enqueue[phase_idx])) {
         enqueue_job(job);
       }
@@ -160,6 +355,7 @@ RuntimeStats_t *Arch::get_cycles(TimeBasedEnqueue &time_enqueues) {
       } else {
         next_phase = MAX_TIME;
       }
+      credit_all_skipped();
       write_stats(phase_idx - 1);
 
       phase_cycles = 0;
@@ -169,8 +365,9 @@ RuntimeStats_t *Arch::get_cycles(TimeBasedEnqueue &time_enqueues) {
     bool enqueued_job = false;
     
     // Core-specific scheduling: each core processes its own job queue
-    bool any_job_assigned = true;
+    bool any_job_assigned = total_frontier > 0;
     while (any_job_assigned) {
+      PROF_SCOPE(DISPATCH);
       any_job_assigned = false;
       for (int core_idx = 0; core_idx < states.size(); ++core_idx) {
         if (!core_queues[core_idx].empty()) {
@@ -184,6 +381,11 @@ RuntimeStats_t *Arch::get_cycles(TimeBasedEnqueue &time_enqueues) {
             total_frontier--;
             
             state->j = job;
+            credit_idle(core_idx);
+            resume_at[core_idx] = skip_from[core_idx] = 0;
+            job->start_cycle = gcycles;
+            job->unit_idx = core_idx;
+            dispatched_jobs.push_back(job);
             LOG_TO_WAVEFORM(STAT_ID(JOB_IDX, state->vcd_idx), job->job_idx);
             state->init();
             enqueued_job = true;
@@ -192,39 +394,16 @@ RuntimeStats_t *Arch::get_cycles(TimeBasedEnqueue &time_enqueues) {
         }
       }
     }
-#ifdef VCD
-    bool first_state_update = true;
-    for (auto pr: state_updates) {
-      const int vcd_id = pr.first;
-      const int to_state = pr.second;
-      if (first_state_update) {
-        first_state_update = false;
-        fprintf(vcd, "#%f\n", (float) gcycles * cycle_adjust);
-      }
-      if (vcd_id >= 0) {
-        int vcd_stat = STAT_EXTRACT(vcd_id);
-        int width = STAT_WIDTH(vcd_stat);
-        fprintf(vcd, "b%s %s\n", int_to_binary(to_state, width).c_str(), rand_chars[vcd_id]);
-      } else {
-        if (vcd_id == PHASE_STATE_IDX) {
-          fprintf(vcd, "b%s ?\n", int_to_binary(phase_idx, 8).c_str());
-        } else {
-          throw std::exception();
-        }
-      }
-      fflush(vcd);
-    }
-    state_updates.clear();
-#endif
 
     gcycles++;
     phase_cycles++;
+#ifndef NO_SELF_PROFILE
+    prof::begin_cycle();
+#endif
 
-#if !defined(SILENCE) && !defined(DSE) || defined(DEBUG)
-    if (logged_job_count != jobs_finished || gcycles % 100000 == 0) {
-      logged_job_count = jobs_finished;
+#ifndef SILENCE
+    if (progress.due()) {
       printf("\rPHASE: %d, Cycles: %llu, Jobs finished: %d/%d, DRAM CMDs: %d", phase_idx, gcycles, jobs_finished, total_jobs, dram_cmds);
-      mem::mem_sys->PrintStats();
       fflush(stdout);
     }
 #endif
@@ -232,18 +411,37 @@ RuntimeStats_t *Arch::get_cycles(TimeBasedEnqueue &time_enqueues) {
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "LoopDoesntUseConditionVariableInspection"
     while (diff_accumulator_mem >= differential_mem) {
+      PROF_SCOPE(CLOCK_TICK);
       mem::mem_sys->ClockTick();
       diff_accumulator_mem -= 1;
     }
 #pragma clang diagnostic pop
 
+    {
+      PROF_SCOPE(INCREMENT);
+      step_units();
+    }
+
+    if (total_idle == states.size() && total_frontier == 0) machine_idle++;
     for (int i = 0; i < states.size(); ++i) {
-      bool is_active = states[i]->increment(enqueue_job, total_idle, n_idle_units);
-      if (is_active) {
-        per_array_act[i]++;
+      if (resume_at[i] == never || (gcycles >= skip_from[i] && gcycles < resume_at[i])) continue;// credited in bulk
+      State *state = states[i];
+      auto &bd = unit_breakdown[i];
+      if (state->is_idle_from_memory && state->mem_read_left > 0) {
+        bd.read_stall++;
+        state->j->read_stall_cycles++;
+      } else if (state->is_idle_from_memory) {
+        bd.write_stall++;
+        state->j->write_stall_cycles++;
+      } else {
+        bd.compute++;
       }
     }
+    if (trace) {
+      trace->record_cycle(gcycles);
+    }
 
+    PROF_SCOPE(ENQUEUE_TX);
     bool successful_enqueue = true;
     for (int j = 0; j < dram_enq_per_cycle && successful_enqueue; ++j) {
       successful_enqueue = mem::try_enqueue_tx();
@@ -251,35 +449,133 @@ RuntimeStats_t *Arch::get_cycles(TimeBasedEnqueue &time_enqueues) {
     }
   }
 
-#ifdef VCD
-  bool first_state_update = true;
-  for (auto pr: state_updates) {
-    const int vcd_id = pr.first;
-    const int to_state = pr.second;
-    if (first_state_update) {
-      first_state_update = false;
-      fprintf(vcd, "#%f\n", (float) gcycles * cycle_adjust);
-    }
-    if (vcd_id >= 0) {
-      int stat_extract = STAT_EXTRACT(vcd_id);
-      fprintf(vcd, "b%s %s\n", int_to_binary(to_state, STAT_WIDTH(stat_extract)).c_str(), rand_chars[vcd_id]);
-    } else {
-      if (vcd_id == PHASE_STATE_IDX) {
-        fprintf(vcd, "b%s ?\n", int_to_binary(phase_idx, 8).c_str());
-      } else {
-        throw std::exception();
-      }
-    }
+
+  if (trace) {
+    trace->close_spans(gcycles);
   }
-  state_updates.clear();
-#endif
 
-  printf("\rPHASE: %d, Cycles: %llu, Time: %fµs Jobs finished: %d/%d, DRAM CMDs: %d", phase_idx, gcycles, double(gcycles) * cycle_adjust / 1000, jobs_finished, total_jobs, dram_cmds);
-  mem::mem_sys->PrintStats();
-  fflush(stdout);
+  if (verbose) {
+    printf("\rPHASE: %d, Cycles: %llu, Time: %fµs Jobs finished: %d/%d, DRAM CMDs: %d", phase_idx, gcycles, double(gcycles) * cycle_adjust / 1000, jobs_finished, total_jobs, dram_cmds);
+    mem::mem_sys->PrintStats();
+    fflush(stdout);
+    std::cout << std::endl;
+  }
+  credit_all_skipped();
+  for (int i = 0; i < states.size(); ++i) {
+    if (resume_at[i] == never) credit_idle(i);
+  }
   write_stats(phase_idx);
+  stop_lanes();
 
-  std::cout << std::endl;
   delete[] n_idle_units;
+  delete[] per_array_act;
+  per_array_act = nullptr;
   return stats;
 }
+
+uint64_t Arch::run_fingerprint() {
+  // FNV-1a over what the graph and the units were built from
+  std::ostringstream ss;
+  ss << batch_size << ' ' << states.size() << ' ' << run.jobs.size() << '\n';
+  for (auto t: run.enqueues->time_points) ss << t << ' ';
+  for (auto *state: states) ss << state->get_ty_idx() << ' ' << state->sz << ' ';
+  for (auto *job: run.jobs) {
+    ss << job->get_type() << ' ' << job->get_job_dims_string() << ' ' << job->addr_hold << ' ' << job->n_deps << ' '
+       << job->core_id << ' ' << job->children.size() << '\n';
+  }
+  uint64_t h = 14695981039346656037ull;
+  for (char c: ss.str()) h = (h ^ (unsigned char) c) * 1099511628211ull;
+  return h;
+}
+
+void Arch::save_run(std::ostream &out) {
+  out.precision(17);// doubles read back exactly
+  out << "cocossim-checkpoint 1 " << run_fingerprint() << '\n';
+  out << gcycles << ' ' << run.phase_idx << ' ' << run.phase_cycles << ' ' << run.next_phase << ' ' << run.dram_cmds
+      << ' ' << run.diff_accumulator_mem << ' ' << jobs_finished << ' ' << mem::reads_done << ' ' << mem::writes_done
+      << ' ' << total_frontier << ' ' << total_idle << ' ' << machine_idle << '\n';
+  for (int ty = 0; ty < run.n_types; ++ty) out << n_idle_units[ty] << ' ';
+  out << '\n';
+  // Time points already passed
+  for (int p = 0; p < run.phase_idx; ++p) {
+    out << run.stats[p].cycles;
+    for (int i = 0; i < states.size(); ++i) out << ' ' << run.stats[p].pct_active[i];
+    out << '\n';
+  }
+  for (int i = 0; i < states.size(); ++i) {
+    auto &bd = unit_breakdown[i];
+    out << (states[i]->j ? run.job_ids.at(states[i]->j) : -1) << ' ' << per_array_act[i] << ' ' << active_cycles[i]
+        << ' ' << bd.compute << ' ' << bd.read_stall << ' ' << bd.write_stall << ' ' << bd.dep_wait << ' ' << bd.idle
+        << ' ' << resume_at[i] << ' ' << skip_from[i] << ' ' << idle_from[i] << ' ' << idle_mark[i] << '\n';
+    states[i]->save(out);
+    out << core_queues[i].size();
+    for (auto *job: core_queues[i]) out << ' ' << run.job_ids.at(job);
+    out << '\n';
+  }
+  out << dispatched_jobs.size();
+  for (auto *job: dispatched_jobs) out << ' ' << run.job_ids.at(job);
+  out << '\n';
+  for (auto *job: run.jobs) job->save(out);
+  // Requests the units queued that DRAM has not taken yet
+  out << to_enqueue.size() << '\n';
+  for (auto &tx: to_enqueue) {
+    int unit = (int) (std::find(states.begin(), states.end(), std::get<3>(tx)) - states.begin());
+    out << std::get<0>(tx) << ' ' << std::get<1>(tx) << ' ' << std::get<2>(tx) << ' ' << unit << '\n';
+  }
+  out << "end\n";
+}
+
+void Arch::load_run(std::istream &in) {
+  std::string magic, end;
+  int version = 0;
+  uint64_t fingerprint = 0;
+  in >> magic >> version >> fingerprint;
+  if (magic != "cocossim-checkpoint" || version != 1) throw std::runtime_error("Error: not a checkpoint file");
+  if (fingerprint != run_fingerprint()) {
+    throw std::runtime_error("Error: the checkpoint was saved from a different model or architecture");
+  }
+  auto job_at = [this, &in]() -> Job * {
+    int id = -1;
+    in >> id;
+    if (id < -1 || id >= (int) run.jobs.size()) throw std::runtime_error("Error: corrupt checkpoint");
+    return id < 0 ? nullptr : run.jobs[id];
+  };
+  in >> gcycles >> run.phase_idx >> run.phase_cycles >> run.next_phase >> run.dram_cmds >> run.diff_accumulator_mem >>
+      jobs_finished >> mem::reads_done >> mem::writes_done >> total_frontier >> total_idle >> machine_idle;
+  if (run.phase_idx < 0 || run.phase_idx >= run.enqueues->time_points.size()) {
+    throw std::runtime_error("Error: corrupt checkpoint");
+  }
+  for (int ty = 0; ty < run.n_types; ++ty) in >> n_idle_units[ty];
+  for (int p = 0; p < run.phase_idx; ++p) {
+    in >> run.stats[p].cycles;
+    for (int i = 0; i < states.size(); ++i) in >> run.stats[p].pct_active[i];
+  }
+  for (int i = 0; i < states.size(); ++i) {
+    auto &bd = unit_breakdown[i];
+    states[i]->j = job_at();
+    in >> per_array_act[i] >> active_cycles[i] >> bd.compute >> bd.read_stall >> bd.write_stall >> bd.dep_wait >>
+        bd.idle >> resume_at[i] >> skip_from[i] >> idle_from[i] >> idle_mark[i];
+    states[i]->load(in);
+    size_t n = 0;
+    in >> n;
+    core_queues[i].clear();
+    for (size_t k = 0; k < n && in; ++k) core_queues[i].push_back(job_at());
+  }
+  size_t n = 0;
+  in >> n;
+  dispatched_jobs.clear();
+  for (size_t k = 0; k < n && in; ++k) dispatched_jobs.push_back(job_at());
+  for (auto *job: run.jobs) job->load(in);
+  in >> n;
+  to_enqueue.clear();
+  for (size_t k = 0; k < n && in; ++k) {
+    uint64_t addr = 0;
+    bool is_write = false;
+    int priority = 0, unit = -1;
+    in >> addr >> is_write >> priority >> unit;
+    if (unit < 0 || unit >= (int) states.size()) throw std::runtime_error("Error: corrupt checkpoint");
+    to_enqueue.emplace_back(addr, is_write, priority, states[unit]);
+  }
+  in >> end;
+  if (!in || end != "end") throw std::runtime_error("Error: the checkpoint is truncated or corrupt");
+}
@@ -0,0 +1,131 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "cocossim.h"
+#include "Simulator.h"
+
+#include <exception>
+#include <string>
+
+struct cocossim_sim {
+  cocossim::Simulator sim;
+  cocossim::RunStats last;
+};
+
+namespace {
+  thread_local std::string last_error;
+
+  // Exceptions must not cross the C ABI
+  template<typename F>
+  int guarded(F &&f) {
+    try {
+      f();
+      return 0;
+    } catch (const std::exception &e) {
+      last_error = e.what();
+    } catch (...) {
+      last_error = "unknown error";
+    }
+    return -1;
+  }
+
+  bool in_range(int idx, size_t n) {
+    if (idx >= 0 && (size_t) idx < n) return true;
+    last_error = "index " + std::to_string(idx) + " out of range";
+    return false;
+  }
+}// namespace
+
+extern "C" {
+
+void cocossim_default_options(cocossim_options *opts) {
+  cocossim::ArchSpec spec;
+  *opts = {spec.cores, spec.sa_sz, spec.vu_sz, spec.ws, spec.freq_ghz, spec.batch_size, spec.dtype_width,
+           spec.map, spec.map_verify, spec.fuse, nullptr, nullptr};
+}
+
+cocossim_sim *cocossim_create(int cores, int sa_sz, int vu_sz, int ws, double freq_ghz, const char *dram_config) {
+  cocossim_options opts;
+  cocossim_default_options(&opts);
+  opts.cores = cores;
+  opts.sa_sz = sa_sz;
+  opts.vu_sz = vu_sz;
+  opts.ws = ws;
+  opts.freq_ghz = freq_ghz;
+  opts.dram_config = dram_config;
+  return cocossim_create_with(&opts);
+}
+
+cocossim_sim *cocossim_create_with(const cocossim_options *opts) {
+  cocossim_sim *out = nullptr;
+  guarded([&] {
+    cocossim::ArchSpec spec;
+    spec.cores = opts->cores;
+    spec.sa_sz = opts->sa_sz;
+    spec.vu_sz = opts->vu_sz;
+    spec.ws = opts->ws != 0;
+    spec.freq_ghz = (float) opts->freq_ghz;
+    spec.batch_size = opts->batch_size;
+    spec.dtype_width = opts->dtype_width;
+    spec.map = opts->map != 0;
+    spec.map_verify = opts->map_verify;
+    spec.fuse = opts->fuse != 0;
+    if (opts->dram_config) spec.dram_config = opts->dram_config;
+    if (opts->dram_output_dir) spec.dram_output_dir = opts->dram_output_dir;
+    out = new cocossim_sim{cocossim::Simulator(spec), {}};
+  });
+  return out;
+}
+
+void cocossim_destroy(cocossim_sim *sim) { delete sim; }
+
+int cocossim_load_model(cocossim_sim *sim, const char *fname) {
+  return guarded([&] { sim->sim.load_model(fname); });
+}
+
+int cocossim_add_layers(cocossim_sim *sim, const char *text) {
+  return guarded([&] { sim->sim.add_layers(text); });
+}
+
+void cocossim_clear_model(cocossim_sim *sim) { sim->sim.clear_model(); }
+
+int cocossim_run(cocossim_sim *sim, cocossim_stats *stats) {
+  return guarded([&] {
+    sim->last = sim->sim.run();
+    const auto &r = sim->last;
+    *stats = {r.cycles, r.time_us, r.jobs, r.dram_reads, r.dram_writes, (int) r.units.size(), (int) r.layers.size()};
+  });
+}
+
+int cocossim_get_unit_stats(const cocossim_sim *sim, int unit, cocossim_unit_stats *stats) {
+  if (!in_range(unit, sim->last.units.size())) return -1;
+  const auto &u = sim->last.units[unit];
+  *stats = {u.active_cycles, u.breakdown.compute, u.breakdown.read_stall, u.breakdown.write_stall,
+            u.breakdown.dep_wait, u.breakdown.idle};
+  return 0;
+}
+
+const char *cocossim_unit_name(const cocossim_sim *sim, int unit) {
+  return in_range(unit, sim->last.units.size()) ? sim->last.units[unit].name.c_str() : nullptr;
+}
+
+int cocossim_get_layer_stats(const cocossim_sim *sim, int layer, cocossim_layer_stats *stats) {
+  if (!in_range(layer, sim->last.layers.size())) return -1;
+  const auto &l = sim->last.layers[layer];
+  *stats = {l.jobs, l.start, l.finish, l.read_stall, l.write_stall, l.bytes_read, l.bytes_written};
+  return 0;
+}
+
+const char *cocossim_layer_name(const cocossim_sim *sim, int layer) {
+  return in_range(layer, sim->last.layers.size()) ? sim->last.layers[layer].name.c_str() : nullptr;
+}
+
+const char *cocossim_last_error(void) { return last_error.c_str(); }
+
+}// extern "C"
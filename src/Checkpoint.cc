@@ -0,0 +1,74 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "Checkpoint.h"
+#include "Fork.h"
+#include "Serving.h"
+#include "Throughput.h"
+#include "Trace.h"
+#include "Waveform.h"
+#include "WhatIf.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+CheckpointConfig checkpoint_config;
+
+namespace {
+  void write_checkpoint(Arch *arch) {
+    auto &file = checkpoint_config.file;
+    // Written aside and renamed, a crash while writing keeps the last checkpoint
+    std::string tmp = file + ".tmp";
+    {
+      std::ofstream out(tmp);
+      arch->save_run(out);
+      if (!out) throw std::runtime_error("Error: could not write checkpoint " + tmp + ": " + strerror(errno));
+    }
+    if (std::rename(tmp.c_str(), file.c_str()) != 0) {
+      throw std::runtime_error("Error: could not write checkpoint " + file + ": " + strerror(errno));
+    }
+    arch->checkpoint_cycle = gcycles + checkpoint_config.every;
+    printf("\rCheckpoint at cycle %llu saved to %s\n", (unsigned long long) gcycles, file.c_str());
+  }
+
+  void restore_checkpoint(Arch *arch) {
+    auto &file = checkpoint_config.restore;
+    std::ifstream in(file);
+    if (!in) throw std::runtime_error("Error: could not open checkpoint " + file + ": " + strerror(errno));
+    arch->load_run(in);
+    if (!checkpoint_config.file.empty()) arch->checkpoint_cycle = gcycles + checkpoint_config.every;
+    printf("Restored %s at cycle %llu\n", file.c_str(), (unsigned long long) gcycles);
+    // DRAMSim3 is not in the checkpoint, the banks it had open and its refresh timers are lost
+    std::cerr << "Warning: the restored run starts on idle DRAM, its cycles can drift from the run that saved "
+              << file << std::endl;
+  }
+}// namespace
+
+void setup_checkpoints(Arch *arch) {
+  if (checkpoint_config.file.empty() && checkpoint_config.restore.empty()) return;
+  if (serving_config.enabled() || whatif_config.report || throughput_config.enabled() || fork_config.enabled()) {
+    throw std::runtime_error("Error: -checkpoint and -restore cannot be combined with -serve, -rate, -whatif, -throughput or -fork");
+  }
+  if (checkpoint_config.every == 0) throw std::runtime_error("Error: -checkpoint_every must be at least 1");
+  // The streaming writers would miss everything before the restored cycle
+  if (!checkpoint_config.restore.empty() && (!trace_file.empty() || waveform)) {
+    throw std::runtime_error("Error: -restore cannot be combined with -trace or -vcd");
+  }
+  if (!checkpoint_config.file.empty()) {
+    arch->checkpoint_cycle = checkpoint_config.every;
+    arch->checkpoint_hook = [arch]() { write_checkpoint(arch); };
+  }
+  if (!checkpoint_config.restore.empty()) {
+    arch->restore_hook = [arch]() { restore_checkpoint(arch); };
+  }
+}
@@ -0,0 +1,141 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "CriticalPath.h"
+#include "NNLayers.h"
+#include "State.h"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+std::string critical_path_file;
+
+namespace {
+  typedef unsigned long long ull;
+
+  std::string layer_name(int idx) {
+    return idx >= 0 && idx < (int) layer_names.size() ? layer_names[idx] : "unknown";
+  }
+
+  std::string unit_name(const Arch *arch, int idx) {
+    return idx < 0 ? "none" : arch->states[idx]->get_ty_string() + "_" + std::to_string(idx);
+  }
+
+  void print_share(const std::string &what, uint64_t cycles, uint64_t total) {
+    printf("  %-20s %14llu %6.2f%%\n", what.c_str(), (ull) cycles, total ? cycles * 100. / total : 0.);
+  }
+}// namespace
+
+void write_critical_path(const Arch *arch, const std::string &fname) {
+  JobList jobs;
+  for (auto *j: arch->dispatched_jobs) {
+    if (j->is_done) jobs.push_back(j);
+  }
+  if (jobs.empty()) return;
+
+  std::unordered_set<const Job *> ran(jobs.begin(), jobs.end());
+  std::unordered_map<const Job *, JobList> parents;
+  // A job that waited for its unit was held up by the job before it on that unit
+  std::unordered_map<const Job *, Job *> prev_on_unit, next_on_unit;
+  std::unordered_map<int, Job *> last_on_unit;
+  Job *last = jobs[0];
+  for (auto *j: jobs) {
+    for (auto *c: j->children) {
+      if (ran.count(c)) parents[c].push_back(j);
+    }
+    auto it = last_on_unit.find(j->unit_idx);
+    if (it != last_on_unit.end()) {
+      prev_on_unit[j] = it->second;
+      next_on_unit[it->second] = j;
+    }
+    last_on_unit[j->unit_idx] = j;
+    if (j->finish_cycle > last->finish_cycle) last = j;
+  }
+  uint64_t end = last->finish_cycle;
+
+  // Latest finish of every job that keeps its successors' recorded starts, with the next job on the
+  // same unit counted as a successor. Successors start after a job finishes, so reverse dispatch
+  // order visits them first.
+  JobList by_start = jobs;
+  std::stable_sort(by_start.begin(), by_start.end(), [](const Job *a, const Job *b) { return a->start_cycle > b->start_cycle; });
+  std::unordered_map<const Job *, uint64_t> latest_finish;
+  auto latest_start = [&](const Job *j) { return latest_finish[j] - (j->finish_cycle - j->start_cycle); };
+  for (auto *j: by_start) {
+    uint64_t lf = end;
+    for (auto *c: j->children) {
+      if (ran.count(c)) lf = std::min(lf, latest_start(c));
+    }
+    auto it = next_on_unit.find(j);
+    if (it != next_on_unit.end()) lf = std::min(lf, latest_start(it->second));
+    latest_finish[j] = lf;
+  }
+
+  // Walk back from the last job, to the job that held the unit if it had to wait for one and to
+  // the parent that released it otherwise
+  std::unordered_set<const Job *> on_path;
+  std::map<std::string, uint64_t> compute;// per unit type
+  std::map<int, int> path_units;          // unit -> jobs on the path
+  uint64_t read_stall = 0, write_stall = 0, unit_wait = 0, not_ready = 0;
+  uint64_t contention_cycles = 0;
+  int contention_hops = 0;
+  for (Job *j = last; j;) {
+    on_path.insert(j);
+    path_units[j->unit_idx]++;
+    uint64_t busy = j->finish_cycle - j->start_cycle;
+    uint64_t stall = std::min(busy, j->read_stall_cycles + j->write_stall_cycles);
+    read_stall += std::min(busy, j->read_stall_cycles);
+    write_stall += stall - std::min(busy, j->read_stall_cycles);
+    compute[arch->states[j->unit_idx]->get_ty_string()] += busy - stall;
+
+    auto up = prev_on_unit.find(j);
+    if (j->start_cycle > j->ready_cycle && up != prev_on_unit.end() && up->second->finish_cycle > j->ready_cycle) {
+      Job *holder = up->second;
+      unit_wait += j->start_cycle - holder->finish_cycle;
+      contention_cycles += holder->finish_cycle - holder->start_cycle;
+      contention_hops++;
+      j = holder;
+      continue;
+    }
+    unit_wait += j->start_cycle - j->ready_cycle;
+
+    Job *prev = nullptr;
+    for (auto *p: parents[j]) {
+      if (p->finish_cycle <= j->ready_cycle && (!prev || p->finish_cycle > prev->finish_cycle)) prev = p;
+    }
+    // Roots, and jobs injected after their parents finished, waited on the driver rather than a job
+    not_ready += j->ready_cycle - (prev ? prev->finish_cycle : 0);
+    j = prev;
+  }
+
+  printf("Critical path: %llu cycles, %zu jobs on %zu units\n", (ull) end, on_path.size(), path_units.size());
+  for (auto &pr: compute) print_share(pr.first + " compute", pr.second, end);
+  print_share("read stall", read_stall, end);
+  print_share("write stall", write_stall, end);
+  print_share("dispatch wait", unit_wait, end);
+  print_share("not yet injected", not_ready, end);
+  printf("  %d jobs on the path waited for a busy unit, the jobs holding it account for %llu cycles\n",
+         contention_hops, (ull) contention_cycles);
+  printf("  units:");
+  for (auto &pr: path_units) printf(" %s (%d)", unit_name(arch, pr.first).c_str(), pr.second);
+  printf("\n");
+
+  FILE *f = fopen(fname.c_str(), "w");
+  if (!f) throw std::runtime_error("Failed to open critical path file '" + fname + "'");
+  fprintf(f, "job,layer,unit,ready,dispatch,finish,latest_finish,slack,critical\n");
+  for (auto *j: jobs) {
+    uint64_t lf = latest_finish[j];
+    fprintf(f, "%d,%s,%s,%llu,%llu,%llu,%llu,%llu,%d\n", j->job_idx, layer_name(j->layer_idx).c_str(),
+            unit_name(arch, j->unit_idx).c_str(), (ull) j->ready_cycle, (ull) j->start_cycle, (ull) j->finish_cycle,
+            (ull) lf, (ull) (lf - j->finish_cycle), (int) on_path.count(j));
+  }
+  fclose(f);
+}
@@ -0,0 +1,68 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "DRAMSystem.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace mem;
+
+ParallelDRAMSystem::ParallelDRAMSystem(dramsim3::Config &config, const std::string &output_dir,
+                                       std::function<void(uint64_t)> read_callback,
+                                       std::function<void(uint64_t)> write_callback, int n_threads)
+    : JedecDRAMSystem(config, output_dir, std::move(read_callback), std::move(write_callback)) {
+  n_threads = std::min<int>(n_threads, (int) ctrls_.size());
+  if (n_threads <= 1) return;
+  pool.reset(new LockstepPool(n_threads));
+  if (pool->size() < n_threads) {
+    std::cerr << "Warning: -dram_threads " << n_threads << " capped to " << pool->size() << " threads, the host cores left" << std::endl;
+  }
+  if (pool->size() == 1) {
+    pool.reset();
+    return;
+  }
+  done.resize(ctrls_.size());
+  for (int t = 0; t <= pool->size(); ++t) bounds.push_back(ctrls_.size() * t / pool->size());
+}
+
+void ParallelDRAMSystem::tick_slice(int t) {
+  for (size_t i = bounds[t]; i < bounds[t + 1]; ++i) {
+    auto &trans = done[i].trans;
+    trans.clear();
+    while (true) {
+      auto pair = ctrls_[i]->ReturnDoneTrans(clk_);
+      if (pair.second < 0) break;
+      trans.push_back(pair);
+    }
+    ctrls_[i]->ClockTick();
+  }
+}
+
+void ParallelDRAMSystem::ClockTick() {
+  if (!pool) {
+    JedecDRAMSystem::ClockTick();
+    return;
+  }
+  auto tick = [this](int t) { tick_slice(t); };
+  pool->run(tick);
+
+  // The callbacks touch simulator state, so they run here, in the serial order
+  for (auto &d: done) {
+    for (auto &pair: d.trans) {
+      if (pair.second == 1) {
+        write_callback_(pair.first);
+      } else {
+        read_callback_(pair.first);
+      }
+    }
+  }
+  clk_++;
+  if (clk_ % config_.epoch_period == 0) PrintEpochStats();
+}
@@ -0,0 +1,229 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "Energy.h"
+#include "Json.h"
+#include "NNLayers.h"
+#include "memory.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+EnergyConfig energy_config;
+
+void EnergyConfig::load(const std::string &params_file) {
+  std::ifstream in(params_file);
+  if (!in) throw std::runtime_error("Failed to open energy parameter file '" + params_file + "'");
+  std::map<std::string, double *> params = {{"sa_mac_pj", &sa_mac_pj},
+                                            {"sa_mac_pj_per_sz", &sa_mac_pj_per_sz},
+                                            {"vu_op_pj", &vu_op_pj},
+                                            {"sram_pj_per_byte", &sram_pj_per_byte},
+                                            {"sa_leak_pj_per_pe", &sa_leak_pj_per_pe},
+                                            {"vu_leak_pj_per_lane", &vu_leak_pj_per_lane},
+                                            {"dram_pj_per_byte", &dram_pj_per_byte}};
+  std::string line;
+  while (std::getline(in, line)) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream ss(line);
+    std::string name;
+    double value;
+    if (!(ss >> name)) continue;
+    auto it = params.find(name);
+    if (it == params.end()) throw std::runtime_error("Unknown energy parameter '" + name + "' in " + params_file);
+    if (!(ss >> value)) throw std::runtime_error("Missing value for energy parameter '" + name + "' in " + params_file);
+    *it->second = value;
+  }
+}
+
+namespace {
+  typedef unsigned long long ull;
+
+  struct LayerEnergy {
+    uint64_t ops = 0;
+    double pj = 0;
+    uint64_t start = UINT64_MAX, finish = 0;
+  };
+
+  bool is_systolic(State *unit) { return unit->get_ty_string() == "SYSTOLIC_ARRAY"; }
+
+  double op_pj(State *unit) {
+    const auto &cfg = energy_config;
+    return is_systolic(unit) ? cfg.sa_mac_pj + cfg.sa_mac_pj_per_sz * unit->sz : cfg.vu_op_pj;
+  }
+
+  double leak_pj_per_cycle(State *unit) {
+    const auto &cfg = energy_config;
+    return is_systolic(unit) ? cfg.sa_leak_pj_per_pe * unit->sz * unit->sz : cfg.vu_leak_pj_per_lane * unit->sz;
+  }
+
+  // DRAMSim3 writes every channel's energy counters to its JSON stats file in PrintStats()
+  bool dramsim3_energy_pj(double &pj) {
+    json::Value stats;
+    try {
+      stats = json::parse_file(mem::dramsim3config->json_stats_name);
+    } catch (const std::exception &) {
+      return false;
+    }
+    bool found = false;
+    pj = 0;
+    for (auto &channel: stats.obj) {
+      if (const auto *e = channel.second.get("total_energy")) {
+        pj += e->as_double();
+        found = true;
+      }
+    }
+    return found;
+  }
+
+  std::string layer_name(int idx) {
+    return idx >= 0 && idx < (int) layer_names.size() ? layer_names[idx] : "unknown";
+  }
+
+  struct RunSnapshot {
+    bool taken = false;
+    uint64_t cycles = 0;
+    bool from_dramsim3 = false;
+    double dram_pj = 0;
+  } snapshot;
+
+  FILE *open_or_throw(const std::string &fname) {
+    FILE *f = fopen(fname.c_str(), "w");
+    if (!f) throw std::runtime_error("Failed to open energy file '" + fname + "'");
+    return f;
+  }
+}// namespace
+
+void snapshot_energy_run() {
+  snapshot.taken = true;
+  snapshot.cycles = gcycles;
+  snapshot.from_dramsim3 = dramsim3_energy_pj(snapshot.dram_pj);
+}
+
+void write_energy(const Arch *arch, const std::string &fname) {
+  const auto &cfg = energy_config;
+  if (cfg.window == 0) throw std::runtime_error("-power_window must be at least one cycle");
+  const uint64_t end = std::max<uint64_t>(snapshot.taken ? snapshot.cycles : gcycles, 1);
+  const double ns_per_cycle = 1. / freq_sa;
+  // pJ over a number of cycles, in W
+  auto watts = [&](double pj, uint64_t cycles) { return pj / ((double) cycles * ns_per_cycle) * 1e-3; };
+
+  JobList jobs;
+  uint64_t dram_bytes = 0;
+  for (auto *j: arch->dispatched_jobs) {
+    if (!j->is_done) continue;
+    jobs.push_back(j);
+    dram_bytes += j->bytes_read + j->bytes_written;
+  }
+  double dram_pj = snapshot.dram_pj;
+  bool from_dramsim3 = snapshot.taken ? snapshot.from_dramsim3 : dramsim3_energy_pj(dram_pj);
+  if (!from_dramsim3) dram_pj = (double) dram_bytes * cfg.dram_pj_per_byte;
+
+  // Energy is spread evenly over the cycles it was spent in
+  size_t n_windows = (end + cfg.window - 1) / cfg.window;
+  std::vector<double> window_pj(n_windows, 0);
+  auto spread = [&](uint64_t from, uint64_t to, double pj) {
+    if (to <= from) {
+      window_pj[std::min<size_t>(from / cfg.window, n_windows - 1)] += pj;
+      return;
+    }
+    double per_cycle = pj / (double) (to - from);
+    for (uint64_t w = from / cfg.window; w < n_windows && w * cfg.window < to; ++w) {
+      uint64_t lo = std::max(from, w * cfg.window), hi = std::min(to, (w + 1) * cfg.window);
+      window_pj[w] += per_cycle * (double) (hi - lo);
+    }
+  };
+
+  double leak_per_cycle = 0;
+  for (auto *unit: arch->states) leak_per_cycle += leak_pj_per_cycle(unit);
+  double leak_pj = leak_per_cycle * (double) end;
+  spread(0, end, leak_pj);
+  if (dram_bytes == 0) spread(0, end, dram_pj);
+
+  // Layers carry the dynamic energy of their jobs, their DRAM share and the leakage of the units
+  // while they ran them
+  double compute_pj = 0, sram_pj = 0;
+  std::map<int, LayerEnergy> layers;
+  for (auto *j: jobs) {
+    State *unit = arch->states[j->unit_idx];
+    uint64_t bytes = j->bytes_read + j->bytes_written;
+    double c = (double) j->ops * op_pj(unit);
+    double s = (double) bytes * cfg.sram_pj_per_byte;
+    double d = dram_bytes ? dram_pj * (double) bytes / (double) dram_bytes : 0;
+    spread(j->start_cycle, j->finish_cycle, c + s + d);
+    compute_pj += c;
+    sram_pj += s;
+
+    auto &l = layers[j->layer_idx];
+    l.ops += j->ops;
+    l.pj += c + s + d + leak_pj_per_cycle(unit) * (double) (j->finish_cycle - j->start_cycle);
+    l.start = std::min(l.start, j->start_cycle);
+    l.finish = std::max(l.finish, j->finish_cycle);
+  }
+
+  double total_pj = compute_pj + sram_pj + dram_pj + leak_pj;
+  double peak_w = 0;
+  for (size_t w = 0; w < n_windows; ++w) {
+    peak_w = std::max(peak_w, watts(window_pj[w], std::min<uint64_t>(cfg.window, end - w * cfg.window)));
+  }
+  auto share = [&](double pj) { return total_pj > 0 ? pj * 100. / total_pj : 0.; };
+  printf("Energy: %.3f uJ, average power %.3f W, peak power %.3f W (%llu cycle windows)\n", total_pj * 1e-6,
+         watts(total_pj, end), peak_w, (ull) cfg.window);
+  printf("  compute %.2f%%, SRAM %.2f%%, DRAM %.2f%% (%s), leakage %.2f%%\n", share(compute_pj), share(sram_pj),
+         share(dram_pj), from_dramsim3 ? "DRAMSim3" : "estimated", share(leak_pj));
+
+  // GOPS/W is ops per nJ
+  auto gops_per_w = [](const LayerEnergy &l) { return l.pj > 0 ? (double) l.ops / l.pj * 1e3 : 0.; };
+  bool as_json = fname.size() >= 5 && fname.compare(fname.size() - 5, 5, ".json") == 0;
+  if (as_json) {
+    FILE *f = open_or_throw(fname);
+    fprintf(f, "{\n  \"total_uj\": %f, \"compute_uj\": %f, \"sram_uj\": %f, \"dram_uj\": %f, \"leakage_uj\": %f,\n"
+               "  \"dram_source\": \"%s\", \"average_power_w\": %f, \"peak_power_w\": %f, \"window_cycles\": %llu,\n"
+               "  \"layers\": [",
+            total_pj * 1e-6, compute_pj * 1e-6, sram_pj * 1e-6, dram_pj * 1e-6, leak_pj * 1e-6,
+            from_dramsim3 ? "dramsim3" : "estimated", watts(total_pj, end), peak_w, (ull) cfg.window);
+    bool first = true;
+    for (auto &pr: layers) {
+      const auto &l = pr.second;
+      fprintf(f, "%s\n    {\"layer\": \"%s\", \"cycles\": %llu, \"ops\": %llu, \"energy_uj\": %f, "
+                 "\"average_power_w\": %f, \"gops_per_w\": %f}",
+              first ? "" : ",", json::escape(layer_name(pr.first)).c_str(), (ull) (l.finish - l.start), (ull) l.ops,
+              l.pj * 1e-6, watts(l.pj, std::max<uint64_t>(l.finish - l.start, 1)), gops_per_w(l));
+      first = false;
+    }
+    fprintf(f, "\n  ],\n  \"power_w\": [");
+    for (size_t w = 0; w < n_windows; ++w) {
+      fprintf(f, "%s%f", w ? ", " : "", watts(window_pj[w], std::min<uint64_t>(cfg.window, end - w * cfg.window)));
+    }
+    fprintf(f, "]\n}\n");
+    fclose(f);
+    return;
+  }
+
+  std::string stem = fname;
+  if (stem.size() >= 4 && stem.compare(stem.size() - 4, 4, ".csv") == 0) stem.resize(stem.size() - 4);
+
+  FILE *f = open_or_throw(fname);
+  fprintf(f, "layer,cycles,ops,energy_uj,average_power_w,gops_per_w\n");
+  for (auto &pr: layers) {
+    const auto &l = pr.second;
+    fprintf(f, "%s,%llu,%llu,%f,%f,%f\n", layer_name(pr.first).c_str(), (ull) (l.finish - l.start), (ull) l.ops,
+            l.pj * 1e-6, watts(l.pj, std::max<uint64_t>(l.finish - l.start, 1)), gops_per_w(l));
+  }
+  fclose(f);
+
+  f = open_or_throw(stem + "_power.csv");
+  fprintf(f, "start_cycle,power_w\n");
+  for (size_t w = 0; w < n_windows; ++w) {
+    fprintf(f, "%llu,%f\n", (ull) (w * cfg.window), watts(window_pj[w], std::min<uint64_t>(cfg.window, end - w * cfg.window)));
+  }
+  fclose(f);
+}
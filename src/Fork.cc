@@ -0,0 +1,154 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "Fork.h"
+#include "CriticalPath.h"
+#include "Energy.h"
+#include "Profiler.h"
+#include "Timeline.h"
+#include "Trace.h"
+#include "Waveform.h"
+#include "WhatIf.h"
+#include "memory.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+
+ForkConfig fork_config;
+
+extern std::string ofile;
+
+namespace {
+  struct Branch {
+    std::string variant;
+    pid_t pid;
+    int result_fd;// read end of the pipe the branch reports its cycles on
+  };
+
+  std::vector<Branch> branches;// in the parent
+  int report_fd = -1;          // in a branch, the write end of its pipe
+  bool forked = false;
+  uint64_t forked_at = 0;
+
+  std::vector<std::string> settings_of(const std::string &variant) {
+    std::vector<std::string> out;
+    std::stringstream ss(variant);
+    std::string s;
+    while (std::getline(ss, s, '+')) out.push_back(s);
+    return out;
+  }
+
+  // "out/tl.json" -> "out/tl.<variant>.json", the extension picks the file format
+  std::string branch_path(const std::string &path, const std::string &variant) {
+    size_t slash = path.find_last_of('/');
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return path + "." + variant;
+    return path.substr(0, dot) + "." + variant + path.substr(dot);
+  }
+
+  // Runs in the new process, before it simulates on from the fork cycle
+  void become_branch(Arch *arch, FILE *out, const std::string &variant) {
+    for (auto &s: settings_of(variant)) {
+      if (s == "ideal_mem") whatif_config.ideal_memory = true;
+      if (s == "ideal_compute") whatif_config.ideal_compute = true;
+      if (s == "unpinned") arch->unpinned = true;
+    }
+    std::string stats = branch_path(ofile, variant);
+    if (!freopen((stats + ".log").c_str(), "w", stdout) || !freopen(stats.c_str(), "w", out)) {
+      std::cerr << "Error: Could not open the outputs of fork " << variant << ": " << strerror(errno) << std::endl;
+      _exit(1);
+    }
+    ofile = stats;
+    for (auto *file: {&timeline_file, &critical_path_file, &energy_config.file}) {
+      if (!file->empty()) *file = branch_path(*file, variant);
+    }
+    auto *dram = mem::dramsim3config;
+    dram->json_stats_name = branch_path(dram->json_stats_name, variant);
+    dram->json_epoch_name = branch_path(dram->json_epoch_name, variant);
+    dram->txt_stats_name = branch_path(dram->txt_stats_name, variant);
+    prof::progress_interval_ms = 0;
+  }
+
+  void fork_branches(Arch *arch, FILE *out) {
+    forked = true;
+    forked_at = gcycles;
+    // Buffered output would be written again by every branch
+    std::cout.flush();
+    fflush(nullptr);
+    for (auto &variant: fork_config.variants) {
+      int fds[2];
+      if (pipe(fds) != 0) throw std::runtime_error(std::string("Error: pipe() failed: ") + strerror(errno));
+      pid_t pid = fork();
+      if (pid < 0) throw std::runtime_error(std::string("Error: fork() failed: ") + strerror(errno));
+      if (pid == 0) {
+        close(fds[0]);
+        for (auto &b: branches) close(b.result_fd);
+        branches.clear();
+        report_fd = fds[1];
+        become_branch(arch, out, variant);
+        return;
+      }
+      close(fds[1]);
+      branches.push_back({variant, pid, fds[0]});
+    }
+  }
+}// namespace
+
+void setup_forks(Arch *arch, FILE *out) {
+  if (!fork_config.enabled()) return;
+  for (auto &variant: fork_config.variants) {
+    for (auto &s: settings_of(variant)) {
+      if (s != "base" && s != "ideal_mem" && s != "ideal_compute" && s != "unpinned") {
+        throw std::runtime_error("Error: unknown -fork setting '" + s + "' in '" + variant + "'");
+      }
+    }
+  }
+  // Host threads do not survive fork(), and the streaming writers cannot be shared between branches
+  if (sim_threads > 1 || mem::tick_threads > 1) throw std::runtime_error("Error: -fork needs -sim_threads 1 and -dram_threads 1");
+  if (!trace_file.empty() || waveform) throw std::runtime_error("Error: -fork cannot be combined with -trace or -vcd");
+  if (whatif_config.report) throw std::runtime_error("Error: -whatif runs its own variants, it cannot be combined with -fork");
+  arch->fork_cycle = fork_config.at;
+  arch->fork_hook = [arch, out]() { fork_branches(arch, out); };
+}
+
+void finish_forks() {
+  if (!fork_config.enabled()) return;
+  if (report_fd >= 0) {
+    dprintf(report_fd, "%llu\n", (unsigned long long) gcycles);
+    close(report_fd);
+    return;
+  }
+  if (!forked) {
+    std::cerr << "Warning: the run ended at cycle " << gcycles << ", before -fork_at " << fork_config.at
+              << ", no variants ran" << std::endl;
+    return;
+  }
+  printf("Forked at cycle %llu\n", (unsigned long long) forked_at);
+  printf("  %-28s %llu cycles\n", "main run", (unsigned long long) gcycles);
+  for (auto &b: branches) {
+    std::string result;
+    char buf[64];
+    ssize_t n;
+    while ((n = read(b.result_fd, buf, sizeof(buf))) > 0) result.append(buf, n);
+    close(b.result_fd);
+    int status = 0;
+    waitpid(b.pid, &status, 0);
+    std::string stats = branch_path(ofile, b.variant);
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0 && !result.empty()) {
+      printf("  %-28s %llu cycles, statistics in %s\n", b.variant.c_str(), std::stoull(result), stats.c_str());
+    } else {
+      printf("  %-28s failed, see %s.log\n", b.variant.c_str(), stats.c_str());
+    }
+  }
+}
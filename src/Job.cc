@@ -11,6 +11,7 @@
 #include "global.h"
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 uint64_t alloc_addr = 0;
 static int job_identifier = 0;
@@ -19,9 +20,23 @@ Job::Job(uint64_t alloc_sz) : rem_deps(0), addr_hold(alloc_addr), addr(alloc_add
   alloc_addr += alloc_sz;
   total_jobs++;
   task_idx = alloc_task_idx;
+  layer_idx = alloc_layer_idx;
+  act_width = alloc_act_width;
+  weight_width = alloc_weight_width;
   job_idx = job_identifier++;
 }
 
+void Job::save(std::ostream &out) const {
+  out << addr << ' ' << rem_deps << ' ' << is_done << ' ' << ready_cycle << ' ' << start_cycle << ' ' << finish_cycle
+      << ' ' << unit_idx << ' ' << first_read_cycle << ' ' << bytes_read << ' ' << bytes_written << ' '
+      << read_stall_cycles << ' ' << write_stall_cycles << ' ' << ops << '\n';
+}
+
+void Job::load(std::istream &in) {
+  in >> addr >> rem_deps >> is_done >> ready_cycle >> start_cycle >> finish_cycle >> unit_idx >> first_read_cycle >>
+      bytes_read >> bytes_written >> read_stall_cycles >> write_stall_cycles >> ops;
+}
+
 void jobs_to_dot(std::vector<Job *> &jobs, const std::string &fname) {
   // Generate DOT graph file for job dependency visualization
   FILE *f = fopen(fname.c_str(), "w");
@@ -57,3 +72,17 @@ void jobs_to_dot(std::vector<Job *> &jobs, const std::string &fname) {
   fprintf(f, "}\n");
   fclose(f);
 }
+
+JobList collect_jobs(const JobList &roots) {
+  JobList out;
+  std::unordered_set<Job *> seen;
+  std::vector<Job *> to_visit = roots;
+  while (!to_visit.empty()) {
+    Job *job = to_visit.back();
+    to_visit.pop_back();
+    if (!seen.insert(job).second) continue;
+    out.push_back(job);
+    for (auto *child: job->children) to_visit.push_back(child);
+  }
+  return out;
+}
@@ -0,0 +1,256 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "Json.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace json;
+
+namespace {
+  struct Reader {
+    const std::string &s;
+    size_t pos = 0;
+
+    explicit Reader(const std::string &s) : s(s) {}
+
+    [[noreturn]] void fail(const std::string &what) const {
+      throw std::runtime_error("JSON parse error at offset " + std::to_string(pos) + ": " + what);
+    }
+
+    void skip_ws() {
+      while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\n' || s[pos] == '\r')) pos++;
+    }
+
+    char peek() {
+      skip_ws();
+      if (pos >= s.size()) fail("unexpected end of input");
+      return s[pos];
+    }
+
+    void expect(char c) {
+      if (peek() != c) fail(std::string("expected '") + c + "'");
+      pos++;
+    }
+
+    bool consume_literal(const char *lit) {
+      size_t n = strlen(lit);
+      if (s.compare(pos, n, lit) == 0) {
+        pos += n;
+        return true;
+      }
+      return false;
+    }
+
+    std::string read_string() {
+      expect('"');
+      std::string out;
+      while (true) {
+        if (pos >= s.size()) fail("unterminated string");
+        char c = s[pos++];
+        if (c == '"') break;
+        if (c != '\\') {
+          out += c;
+          continue;
+        }
+        if (pos >= s.size()) fail("unterminated escape");
+        char e = s[pos++];
+        switch (e) {
+          case '"': out += '"'; break;
+          case '\\': out += '\\'; break;
+          case '/': out += '/'; break;
+          case 'b': out += '\b'; break;
+          case 'f': out += '\f'; break;
+          case 'n': out += '\n'; break;
+          case 'r': out += '\r'; break;
+          case 't': out += '\t'; break;
+          case 'u': {
+            if (pos + 4 > s.size()) fail("bad unicode escape");
+            unsigned cp = std::stoul(s.substr(pos, 4), nullptr, 16);
+            pos += 4;
+            // Names in model graphs are ASCII; anything else is kept as UTF-8 for the BMP
+            if (cp < 0x80) {
+              out += char(cp);
+            } else if (cp < 0x800) {
+              out += char(0xC0 | (cp >> 6));
+              out += char(0x80 | (cp & 0x3F));
+            } else {
+              out += char(0xE0 | (cp >> 12));
+              out += char(0x80 | ((cp >> 6) & 0x3F));
+              out += char(0x80 | (cp & 0x3F));
+            }
+          } break;
+          default:
+            fail("bad escape");
+        }
+      }
+      return out;
+    }
+
+    Value read_value() {
+      Value v;
+      char c = peek();
+      if (c == '{') {
+        pos++;
+        v.type = Value::object_t;
+        if (peek() == '}') {
+          pos++;
+          return v;
+        }
+        while (true) {
+          std::string key = read_string();
+          expect(':');
+          v.obj[key] = read_value();
+          if (peek() == ',') {
+            pos++;
+            continue;
+          }
+          expect('}');
+          break;
+        }
+      } else if (c == '[') {
+        pos++;
+        v.type = Value::array_t;
+        if (peek() == ']') {
+          pos++;
+          return v;
+        }
+        while (true) {
+          v.arr.push_back(read_value());
+          if (peek() == ',') {
+            pos++;
+            continue;
+          }
+          expect(']');
+          break;
+        }
+      } else if (c == '"') {
+        v.type = Value::string_t;
+        v.str = read_string();
+      } else if (consume_literal("true")) {
+        v.type = Value::bool_t;
+        v.b = true;
+      } else if (consume_literal("false")) {
+        v.type = Value::bool_t;
+      } else if (consume_literal("null")) {
+        v.type = Value::null_t;
+      } else if (consume_literal("NaN")) {
+        v.type = Value::number_t;
+        v.num = NAN;
+      } else {
+        const char *start = s.c_str() + pos;
+        char *end;
+        v.num = std::strtod(start, &end);
+        if (end == start) fail(std::string("unexpected character '") + c + "'");
+        v.type = Value::number_t;
+        pos += end - start;
+      }
+      return v;
+    }
+  };
+}// namespace
+
+const Value *Value::get(const std::string &key) const {
+  if (type != object_t) return nullptr;
+  auto it = obj.find(key);
+  return it == obj.end() ? nullptr : &it->second;
+}
+
+const Value &Value::at(const std::string &key) const {
+  auto *v = get(key);
+  if (v == nullptr) throw std::runtime_error("JSON: missing member '" + key + "'");
+  return *v;
+}
+
+int64_t Value::as_int() const {
+  if (type == bool_t) return b;
+  if (type != number_t) throw std::runtime_error("JSON: expected a number");
+  return (int64_t) std::llround(num);
+}
+
+double Value::as_double() const {
+  if (type != number_t) throw std::runtime_error("JSON: expected a number");
+  return num;
+}
+
+const std::string &Value::as_string() const {
+  if (type != string_t) throw std::runtime_error("JSON: expected a string");
+  return str;
+}
+
+std::vector<int64_t> Value::as_int_vector() const {
+  std::vector<int64_t> out;
+  if (type == number_t) {
+    out.push_back(as_int());
+    return out;
+  }
+  if (type != array_t) throw std::runtime_error("JSON: expected an array of numbers");
+  for (const auto &e: arr) out.push_back(e.as_int());
+  return out;
+}
+
+int64_t Value::get_int(const std::string &key, int64_t dflt) const {
+  auto *v = get(key);
+  return (v == nullptr || v->is_null()) ? dflt : v->as_int();
+}
+
+double Value::get_double(const std::string &key, double dflt) const {
+  auto *v = get(key);
+  return (v == nullptr || v->is_null()) ? dflt : v->as_double();
+}
+
+std::string Value::get_string(const std::string &key, const std::string &dflt) const {
+  auto *v = get(key);
+  return (v == nullptr || v->is_null()) ? dflt : v->as_string();
+}
+
+Value json::parse(const std::string &text) {
+  Reader r(text);
+  Value v = r.read_value();
+  r.skip_ws();
+  if (r.pos != text.size()) r.fail("trailing characters");
+  return v;
+}
+
+Value json::parse_file(const std::string &fname) {
+  std::ifstream f(fname);
+  if (!f.is_open()) {
+    throw std::runtime_error("Error: Could not open JSON file: " + fname);
+  }
+  std::stringstream ss;
+  ss << f.rdbuf();
+  return parse(ss.str());
+}
+
+std::string json::escape(const std::string &s) {
+  std::string out;
+  for (char c: s) {
+    switch (c) {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      default:
+        if ((unsigned char) c < 0x20) {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\u%04x", c);
+          out += buf;
+        } else {
+          out += c;
+        }
+    }
+  }
+  return out;
+}
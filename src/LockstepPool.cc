@@ -0,0 +1,111 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "LockstepPool.h"
+
+#include <algorithm>
+
+namespace {
+  // Spin this many times on the barrier before yielding the core
+  const int spins_before_yield = 4096;
+  // A worker that waited this many times for a task sleeps, e.g. through serially stepped cycles
+  const int waits_before_park = 1 << 16;
+
+  // Worker threads of all live pools
+  std::mutex budget_mutex;
+  int workers_in_use = 0;
+
+  template<typename F>
+  void spin_until(F &&ready) {
+    for (int n = 0; !ready(); ++n) {
+      if (n >= spins_before_yield) std::this_thread::yield();
+    }
+  }
+}// namespace
+
+LockstepPool::LockstepPool(int n_threads) : n_threads(std::max(1, n_threads)) {
+  // Sharing a core with another spinning thread stalls both, e.g. -sim_threads next to -dram_threads
+  int cores = (int) std::thread::hardware_concurrency();
+  if (cores > 0) {
+    std::lock_guard<std::mutex> lock(budget_mutex);
+    this->n_threads = std::max(1, std::min(this->n_threads, cores - workers_in_use));
+    workers_in_use += this->n_threads - 1;
+  }
+  errors.resize(this->n_threads);
+  // The calling thread is thread 0
+  for (int t = 1; t < this->n_threads; ++t) workers.emplace_back(&LockstepPool::worker, this, t);
+}
+
+LockstepPool::~LockstepPool() {
+  stop.store(true, std::memory_order_relaxed);
+  start_task();
+  for (auto &w: workers) w.join();
+  if (std::thread::hardware_concurrency() > 0) {
+    std::lock_guard<std::mutex> lock(budget_mutex);
+    workers_in_use -= n_threads - 1;
+  }
+}
+
+void LockstepPool::start_task() {
+  // Both sides use seq_cst: either the worker sees the new generation before it sleeps, or this
+  // sees it parked and wakes it
+  generation.fetch_add(1);
+  if (parked.load() > 0) {
+    std::lock_guard<std::mutex> lock(park_mutex);
+    park_cv.notify_all();
+  }
+}
+
+void LockstepPool::wait_for_task(uint64_t seen) {
+  for (int n = 0; n < waits_before_park; ++n) {
+    if (generation.load(std::memory_order_acquire) != seen) return;
+    if (n >= spins_before_yield) std::this_thread::yield();
+  }
+  std::unique_lock<std::mutex> lock(park_mutex);
+  parked.fetch_add(1);
+  park_cv.wait(lock, [&] { return generation.load() != seen; });
+  parked.fetch_sub(1);
+}
+
+void LockstepPool::worker(int t) {
+  uint64_t seen = 0;
+  while (true) {
+    wait_for_task(seen);
+    seen++;
+    if (stop.load(std::memory_order_relaxed)) return;
+    try {
+      task(task_ctx, t);
+    } catch (...) {
+      errors[t] = std::current_exception();
+    }
+    finished.fetch_add(1, std::memory_order_release);
+  }
+}
+
+void LockstepPool::run_task() {
+  if (workers.empty()) {
+    task(task_ctx, 0);
+    return;
+  }
+  finished.store(0, std::memory_order_relaxed);
+  start_task();
+  try {
+    task(task_ctx, 0);
+  } catch (...) {
+    errors[0] = std::current_exception();
+  }
+  spin_until([&] { return finished.load(std::memory_order_acquire) == (int) workers.size(); });
+  for (auto &e: errors) {
+    if (e) {
+      std::exception_ptr first = e;
+      std::fill(errors.begin(), errors.end(), nullptr);
+      std::rethrow_exception(first);
+    }
+  }
+}
@@ -8,6 +8,9 @@
  */
 
 #include "NNLayers.h"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
 #include <vector>
 
 void connectJobLists(JobList &source, JobList &target) {
@@ -29,4 +32,68 @@ void printJobQueue(const std::vector<Job *> &job_queue) {
 
 void connectJobs(JobPair& parent, JobPair& child) {
   connectJobLists(parent.second, child.first);
-}
\ No newline at end of file
+}
+
+void connectLayerGraph(const std::vector<LayerConfig> &configs, std::vector<JobPair> &layers,
+                       std::vector<int> &roots, std::vector<int> &sinks) {
+  std::unordered_map<std::string, int> producer;
+  for (int i = 0; i < (int) configs.size(); ++i) {
+    for (const auto &t: configs[i].outputs) {
+      if (!producer.emplace(t, i).second) {
+        throw std::runtime_error("Tensor '" + t + "' is produced by more than one layer");
+      }
+    }
+  }
+
+  std::vector<bool> consumed(layers.size(), false);
+  for (int i = 0; i < (int) layers.size(); ++i) {
+    std::vector<int> parents;
+    if (configs[i].inputs.empty()) {
+      if (i > 0) parents.push_back(i - 1);
+    } else {
+      for (const auto &t: configs[i].inputs) {
+        auto it = producer.find(t);
+        if (it == producer.end()) {
+          // Most likely a misspelt tensor when it is not declared, the layer would silently become a root
+          const auto &declared = configs[i].graph_inputs;
+          if (std::find(declared.begin(), declared.end(), t) == declared.end()) {
+            std::cerr << "Warning: layer " << i << " (" << configs[i].layer_type << ") reads tensor '" << t
+                      << "', which no layer produces and no Input line declares, treating it as a graph input"
+                      << std::endl;
+          }
+          continue;
+        }
+        if (it->second >= i) {
+          throw std::runtime_error("Tensor '" + t + "' is consumed before it is produced, layers must be listed in topological order");
+        }
+        if (std::find(parents.begin(), parents.end(), it->second) == parents.end()) {
+          parents.push_back(it->second);
+        }
+      }
+    }
+    for (int p: parents) {
+      connectJobLists(layers[p].second, layers[i].first);
+      consumed[p] = true;
+    }
+    if (parents.empty()) roots.push_back(i);
+  }
+  for (int i = 0; i < (int) layers.size(); ++i) {
+    if (!consumed[i]) sinks.push_back(i);
+  }
+}
+
+std::vector<std::string> layer_names;
+
+int layer_index(const LayerConfig &config, int position) {
+  std::string name = std::to_string(position) + ":" + config.layer_type;
+  if (!config.outputs.empty()) name += ":" + config.outputs[0];
+  return layer_index(name);
+}
+
+int layer_index(const std::string &name) {
+  static std::unordered_map<std::string, int> indices;
+  auto it = indices.find(name);
+  if (it != indices.end()) return it->second;
+  layer_names.push_back(name);
+  return indices[name] = (int) layer_names.size() - 1;
+}
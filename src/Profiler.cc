@@ -0,0 +1,64 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace prof {
+  Counter counters[N_REGIONS];
+  bool sampling = false;
+  uint64_t sample_rng = 0x9E3779B97F4A7C15ull;
+  uint64_t read_overhead = 0;
+  Scope *open_scope = nullptr;
+  int progress_interval_ms = 1000;
+
+  static const char *region_names[N_REGIONS] = {"increment", "dispatch", "try_enqueue_tx", "ClockTick", "callbacks"};
+  static std::chrono::steady_clock::time_point start_time;
+  static uint64_t start_ticks;
+
+  void start() {
+    read_overhead = UINT64_MAX;
+    for (int i = 0; i < 1000; ++i) {
+      uint64_t t = now();
+      read_overhead = std::min(read_overhead, now() - t);
+    }
+    start_time = std::chrono::steady_clock::now();
+    start_ticks = now();
+  }
+
+  void print_summary(uint64_t sim_cycles, uint64_t dram_transactions) {
+    double host_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    double ticks_per_s = (double) (now() - start_ticks) / host_s;
+    printf("Self-profile: %.3f s host, %.3f M simulated cycles/s, %.3f M DRAM transactions/s\n", host_s,
+           (double) sim_cycles / host_s / 1e6, (double) dram_transactions / host_s / 1e6);
+#ifndef NO_SELF_PROFILE
+    for (int r = 0; r < N_REGIONS; ++r) {
+      const auto &c = counters[r];
+      if (c.sampled_calls == 0) {
+        printf("  %-16s %21s %12llu calls\n", region_names[r], "", (unsigned long long) c.calls);
+        continue;
+      }
+      uint64_t ticks = c.ticks - std::min(c.ticks, c.sampled_calls * read_overhead);
+      double s = (double) ticks * c.calls / c.sampled_calls / ticks_per_s;
+      printf("  %-16s %10.3f ms %6.2f%% %12llu calls\n", region_names[r], s * 1e3, s * 100. / host_s,
+             (unsigned long long) c.calls);
+    }
+#endif
+  }
+
+  bool ProgressReporter::due() {
+    if (progress_interval_ms <= 0 || (++calls & 4095) != 0) return false;
+    auto t = std::chrono::steady_clock::now();
+    if (t - last < std::chrono::milliseconds(progress_interval_ms)) return false;
+    last = t;
+    return true;
+  }
+}// namespace prof
@@ -0,0 +1,159 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "Server.h"
+#include "Json.h"
+
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+
+ServerConfig server_config;
+
+using namespace cocossim;
+
+namespace {
+  using ull = unsigned long long;
+
+  // A simulator with its model loaded, and its job graph once it has run
+  struct CachedSim {
+    std::string key;
+    std::unique_ptr<Simulator> sim;
+  };
+
+  // Model files are keyed with their modification time, so an edited model is rebuilt
+  std::string model_key(const std::string &fname) {
+    struct stat st{};
+    if (stat(fname.c_str(), &st) != 0) throw std::runtime_error("Error: Could not open model file: " + fname);
+    return "file " + fname + " " + std::to_string((long long) st.st_mtime);
+  }
+
+  ArchSpec spec_of(const json::Value &req, const ArchSpec &defaults) {
+    ArchSpec spec = defaults;
+    if (const json::Value *a = req.get("arch")) {
+      spec.cores = (int) a->get_int("cores", spec.cores);
+      spec.sa_sz = (int) a->get_int("sa_sz", spec.sa_sz);
+      spec.vu_sz = (int) a->get_int("vu_sz", spec.vu_sz);
+      spec.ws = a->get_int("ws", spec.ws) != 0;
+      spec.freq_ghz = (float) a->get_double("freq", spec.freq_ghz);
+      spec.batch_size = (int) a->get_int("batch", spec.batch_size);
+      if (const json::Value *dtype = a->get("dtype")) {
+        spec.dtype_width = dtype->is_string() ? dtype_width(dtype->str) : (int) dtype->as_int();
+      }
+      spec.map = a->get_int("map", spec.map) != 0;
+      spec.map_verify = (int) a->get_int("map_verify", spec.map_verify);
+      spec.fuse = a->get_int("fuse", spec.fuse) != 0;
+    }
+    spec.dram_config = req.get_string("dram_config", spec.dram_config);
+    return spec;
+  }
+
+  // The request id echoed back as JSON, numbers and strings only
+  std::string id_of(const json::Value &req) {
+    const json::Value *id = req.get("id");
+    if (id == nullptr) return "null";
+    if (id->is_string()) return "\"" + json::escape(id->str) + "\"";
+    if (!id->is_number()) return "null";
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.17g", id->num);
+    return buf;
+  }
+
+  class SimCache {
+  public:
+    explicit SimCache(size_t max_entries) : max_entries(std::max<size_t>(max_entries, 1)) {}
+
+    // The simulator for the request's arch, DRAM config and workload, loading it on a miss
+    Simulator &get(const json::Value &req, const ArchSpec &defaults) {
+      ArchSpec spec = spec_of(req, defaults);
+      const json::Value *model = req.get("model");
+      const json::Value *layers = req.get("layers");
+      if ((model == nullptr) == (layers == nullptr)) throw std::runtime_error("request needs one of \"model\" or \"layers\"");
+      std::string key = std::to_string(spec.cores) + " " + std::to_string(spec.sa_sz) + " " +
+                        std::to_string(spec.vu_sz) + " " + std::to_string(spec.ws) + " " +
+                        std::to_string(spec.freq_ghz) + " " + std::to_string(spec.batch_size) + " " +
+                        std::to_string(spec.dtype_width) + " " + std::to_string(spec.map) + " " +
+                        std::to_string(spec.map_verify) + " " + std::to_string(spec.fuse) + " " + spec.dram_config + "\n" +
+                        (model ? model_key(model->as_string()) : "text " + layers->as_string());
+
+      for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (it->key == key) {
+          entries.splice(entries.begin(), entries, it);
+          return *entries.front().sim;
+        }
+      }
+      std::unique_ptr<Simulator> sim(new Simulator(spec));
+      if (model) {
+        sim->load_model(model->as_string());
+      } else {
+        sim->add_layers(layers->as_string());
+      }
+      entries.push_front({key, std::move(sim)});
+      if (entries.size() > max_entries) entries.pop_back();
+      return *entries.front().sim;
+    }
+
+  private:
+    size_t max_entries;
+    std::list<CachedSim> entries;// most recently used first
+  };
+
+  void write_result(FILE *out, const std::string &id, const RunStats &r, double host_ms) {
+    fprintf(out, "{\"id\": %s, \"ok\": true, \"cycles\": %llu, \"time_us\": %f, \"jobs\": %d, "
+                 "\"dram_reads\": %llu, \"dram_writes\": %llu, \"reused_graph\": %s, \"host_ms\": %.3f, \"units\": [",
+            id.c_str(), (ull) r.cycles, r.time_us, r.jobs, (ull) r.dram_reads, (ull) r.dram_writes,
+            r.reused_graph ? "true" : "false", host_ms);
+    for (size_t i = 0; i < r.units.size(); ++i) {
+      const auto &u = r.units[i];
+      fprintf(out, "%s{\"name\": \"%s\", \"active\": %llu, \"compute\": %llu, \"read_stall\": %llu, "
+                   "\"write_stall\": %llu, \"dep_wait\": %llu, \"idle\": %llu}",
+              i ? ", " : "", json::escape(u.name).c_str(), (ull) u.active_cycles, (ull) u.breakdown.compute,
+              (ull) u.breakdown.read_stall, (ull) u.breakdown.write_stall, (ull) u.breakdown.dep_wait,
+              (ull) u.breakdown.idle);
+    }
+    fprintf(out, "], \"layers\": [");
+    for (size_t i = 0; i < r.layers.size(); ++i) {
+      const auto &l = r.layers[i];
+      fprintf(out, "%s{\"name\": \"%s\", \"jobs\": %d, \"start\": %llu, \"finish\": %llu, \"read_stall\": %llu, "
+                   "\"write_stall\": %llu, \"bytes_read\": %llu, \"bytes_written\": %llu}",
+              i ? ", " : "", json::escape(l.name).c_str(), l.jobs, (ull) l.start, (ull) l.finish,
+              (ull) l.read_stall, (ull) l.write_stall, (ull) l.bytes_read, (ull) l.bytes_written);
+    }
+    fprintf(out, "]}\n");
+  }
+}// namespace
+
+void run_server(const ArchSpec &defaults, std::istream &in, FILE *out) {
+  SimCache cache(server_config.max_graphs);
+  // Anything printed before this line is startup logging
+  fprintf(out, "{\"ready\": true}\n");
+  fflush(out);
+
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+    auto t0 = std::chrono::steady_clock::now();
+    std::string id = "null";
+    try {
+      json::Value req = json::parse(line);
+      if (!req.is_object()) throw std::runtime_error("request must be a JSON object");
+      id = id_of(req);
+      if (req.get_string("cmd", "") == "quit") break;
+      RunStats stats = cache.get(req, defaults).run();
+      double host_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+      write_result(out, id, stats, host_ms);
+    } catch (const std::exception &e) {
+      fprintf(out, "{\"id\": %s, \"ok\": false, \"error\": \"%s\"}\n", id.c_str(), json::escape(e.what()).c_str());
+    }
+    fflush(out);
+  }
+}
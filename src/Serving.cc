@@ -0,0 +1,174 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "Serving.h"
+#include "memory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+
+ServingConfig serving_config;
+
+static uint64_t us_to_cycles(double us) {
+  return (uint64_t) std::llround(us * 1000. * freq_sa);
+}
+
+static std::vector<Request> read_trace(const std::string &fname) {
+  std::ifstream trace(fname);
+  if (!trace.is_open()) {
+    throw std::runtime_error("Error: Could not open arrival trace: " + fname);
+  }
+  // Model paths may be given relative to the trace file
+  std::string dir;
+  auto slash = fname.find_last_of('/');
+  if (slash != std::string::npos) dir = fname.substr(0, slash + 1);
+
+  std::vector<Request> requests;
+  std::string line;
+  int line_no = 0;
+  while (std::getline(trace, line)) {
+    line_no++;
+    auto comment = line.find('#');
+    if (comment != std::string::npos) line.resize(comment);
+    std::stringstream ss(line);
+    double arrival_us;
+    Request r;
+    if (!(ss >> arrival_us)) continue;
+    if (!(ss >> r.model_file)) {
+      throw std::runtime_error(fname + ":" + std::to_string(line_no) + ": expected '<arrival_us> <model_file> [samples]'");
+    }
+    ss >> r.samples;
+    if (r.samples < 1 || arrival_us < 0) {
+      throw std::runtime_error(fname + ":" + std::to_string(line_no) + ": bad arrival time or sample count");
+    }
+    if (!std::ifstream(r.model_file).good() && !dir.empty() && r.model_file[0] != '/') {
+      r.model_file = dir + r.model_file;
+    }
+    r.arrival = us_to_cycles(arrival_us);
+    requests.push_back(r);
+  }
+  return requests;
+}
+
+static std::vector<Request> generate_arrivals(const ServingConfig &cfg, const std::string &model) {
+  // Poisson process of bursts; the burst rate is scaled so the mean request rate stays `rate_per_us`
+  std::mt19937_64 rng(cfg.seed);
+  std::exponential_distribution<double> gap(cfg.rate_per_us / cfg.burst);
+  std::vector<Request> requests;
+  double t_us = 0;
+  while ((int) requests.size() < cfg.n_requests) {
+    for (int b = 0; b < cfg.burst && (int) requests.size() < cfg.n_requests; ++b) {
+      Request r;
+      r.arrival = us_to_cycles(t_us);
+      r.model_file = model;
+      requests.push_back(r);
+    }
+    t_us += gap(rng);
+  }
+  return requests;
+}
+
+static uint64_t percentile(std::vector<uint64_t> v, double p) {
+  // nearest-rank
+  std::sort(v.begin(), v.end());
+  size_t rank = (size_t) std::ceil(p / 100. * v.size());
+  return v[std::max<size_t>(rank, 1) - 1];
+}
+
+void run_serving(Arch *arch, const parser_for_f &parser_for, const std::string &default_model, FILE *f) {
+  std::vector<Request> requests = serving_config.trace_file.empty()
+                                          ? generate_arrivals(serving_config, default_model)
+                                          : read_trace(serving_config.trace_file);
+  if (requests.empty()) throw std::runtime_error("Serving: no requests to simulate");
+  std::stable_sort(requests.begin(), requests.end(), [](const Request &a, const Request &b) { return a.arrival < b.arrival; });
+
+  // Build every request's graph up front; each model file is parsed once
+  std::map<std::string, std::vector<LayerConfig>> models;
+  for (auto &r: requests) {
+    auto it = models.find(r.model_file);
+    if (it == models.end()) {
+      it = models.emplace(r.model_file, parser_for(r.model_file).read_layers(r.model_file)).first;
+    }
+    for (int s = 0; s < r.samples; ++s) {
+      for (auto &layer: parser_for(r.model_file).make_layers(it->second)) {
+        r.roots.insert(r.roots.end(), layer.first.begin(), layer.first.end());
+      }
+      alloc_task_idx++;
+    }
+  }
+
+  // Requests arriving on the same cycle share one time point; the first time point must be 0
+  TimeBasedEnqueue time_enqueues;
+  std::deque<std::vector<Job *>> arrivals;
+  if (requests.front().arrival != 0) {
+    arrivals.emplace_back();
+    time_enqueues.enqueue_at(0, &arrivals.back());
+  }
+  for (auto &r: requests) {
+    if (time_enqueues.time_points.empty() || time_enqueues.time_points.back() != r.arrival) {
+      arrivals.emplace_back();
+      time_enqueues.enqueue_at(r.arrival, &arrivals.back());
+    }
+    arrivals.back().insert(arrivals.back().end(), r.roots.begin(), r.roots.end());
+  }
+  std::cout << "Serving " << requests.size() << " requests over " << time_enqueues.time_points.size() << " arrival points" << std::endl;
+
+  mem::mem_sys->ResetStats();
+  auto *res = arch->get_cycles(time_enqueues);
+
+  std::vector<uint64_t> queueing, service, latency;
+  uint64_t last_finish = 0;
+  for (auto &r: requests) {
+    r.first_dispatch = UINT64_MAX;
+    for (auto *job: collect_jobs(r.roots)) {
+      r.first_dispatch = std::min(r.first_dispatch, job->start_cycle);
+      r.finish = std::max(r.finish, job->finish_cycle);
+    }
+    queueing.push_back(r.first_dispatch - r.arrival);
+    service.push_back(r.finish - r.first_dispatch);
+    latency.push_back(r.finish - r.arrival);
+    last_finish = std::max(last_finish, r.finish);
+  }
+
+  const double us_per_cycle = 1. / freq_sa / 1000.;
+  for (int i = 0; i < (int) requests.size(); ++i) {
+    fprintf(f, "Request %d %s arrival %llu queueing %llu service %llu latency %llu\n", i, requests[i].model_file.c_str(),
+            (unsigned long long) requests[i].arrival, (unsigned long long) queueing[i],
+            (unsigned long long) service[i], (unsigned long long) latency[i]);
+  }
+  double span_us = (double) (last_finish - requests.front().arrival) * us_per_cycle;
+  double throughput = (double) requests.size() / span_us * 1e6;
+  double mean_queueing = 0;
+  for (auto q: queueing) mean_queueing += (double) q / (double) queueing.size();
+
+  fprintf(f, "Cycles %llu\n", (unsigned long long) last_finish);
+  fprintf(f, "Throughput %f\n", throughput);
+  fprintf(f, "MeanQueueing %f\n", mean_queueing);
+  for (double p: {50., 95., 99.}) {
+    fprintf(f, "P%d %llu\n", (int) p, (unsigned long long) percentile(latency, p));
+  }
+  // Utilisation over the whole run, from the per-arrival-interval stats
+  uint64_t total_cycles = 0;
+  for (size_t p = 0; p < time_enqueues.time_points.size(); ++p) total_cycles += res[p].cycles;
+  for (int i = 0; i < (int) arch->states.size(); ++i) {
+    double active = 0;
+    for (size_t p = 0; p < time_enqueues.time_points.size(); ++p) active += res[p].pct_active[i] * (double) res[p].cycles;
+    fprintf(f, "%s %f\n", arch->states[i]->get_ty_string().c_str(), total_cycles ? active / (double) total_cycles : 0.);
+  }
+
+  printf("Served %zu requests in %f us: %f requests/s, mean queueing %f us\n", requests.size(), span_us, throughput,
+         mean_queueing * us_per_cycle);
+  printf("Latency p50 %f us, p95 %f us, p99 %f us\n", percentile(latency, 50) * us_per_cycle,
+         percentile(latency, 95) * us_per_cycle, percentile(latency, 99) * us_per_cycle);
+}
@@ -0,0 +1,170 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "Simulator.h"
+#include "NNLayers.h"
+#include "Profiler.h"
+#include "State.h"
+#include "frontends/standard/Fusion.h"
+#include "frontends/standard/LLMInference.h"
+#include "frontends/standard/Mapper.h"
+#include "frontends/standard/StandardArch.h"
+#include "frontends/standard/StandardLayer.h"
+#include "frontends/torch/TorchLayer.h"
+#include "memory.h"
+
+#include <map>
+#include <memory>
+#include <sstream>
+
+using namespace cocossim;
+
+namespace {
+  // Silences std::cout and the progress line for its lifetime
+  struct QuietScope {
+    std::streambuf *saved_buf = nullptr;
+    int saved_progress = 0;
+    bool on;
+    explicit QuietScope(bool on) : on(on) {
+      if (!on) return;
+      saved_buf = std::cout.rdbuf(nullptr);
+      saved_progress = prof::progress_interval_ms;
+      prof::progress_interval_ms = 0;
+    }
+    ~QuietScope() {
+      if (!on) return;
+      std::cout.rdbuf(saved_buf);
+      std::cout.clear();
+      prof::progress_interval_ms = saved_progress;
+    }
+  };
+}// namespace
+
+Simulator::Simulator(const ArchSpec &spec, bool quiet) : spec(spec), quiet(quiet) {
+  if (spec.cores < 1 || spec.sa_sz < 1 || spec.vu_sz < 1 || spec.freq_ghz <= 0 || spec.batch_size < 1 ||
+      spec.dtype_width < 1) {
+    throw std::runtime_error("Simulator: cores, array sizes, frequency, batch size and datatype width must be positive");
+  }
+}
+
+Simulator::Simulator(Simulator &&other) noexcept
+    : spec(std::move(other.spec)), quiet(other.quiet), configs(std::move(other.configs)),
+      roots(std::move(other.roots)), jobs(std::move(other.jobs)) {
+  other.roots.clear();
+  other.jobs.clear();
+}
+
+Simulator::~Simulator() { free_graph(); }
+
+void Simulator::free_graph() {
+  for (auto *j: jobs) delete j;
+  roots.clear();
+  jobs.clear();
+  frontend::standard::clear_mappings();
+  frontend::standard::llm_runs.clear();
+}
+
+void Simulator::clear_model() {
+  free_graph();
+  configs.clear();
+}
+
+void Simulator::load_model(const std::string &fname) {
+  QuietScope q(quiet);
+  free_graph();
+  bool is_graph = fname.size() >= 5 && fname.compare(fname.size() - 5, 5, ".json") == 0;
+  auto layers = is_graph ? frontend::torch::TorchLayer().read_layers(fname) : LayerParser().read_layers(fname);
+  configs.insert(configs.end(), layers.begin(), layers.end());
+}
+
+void Simulator::add_layers(const std::string &text) {
+  QuietScope q(quiet);
+  free_graph();
+  std::istringstream in(text);
+  auto layers = LayerParser::parse_layers(in, "<text>");
+  configs.insert(configs.end(), layers.begin(), layers.end());
+}
+
+RunStats Simulator::run() {
+  if (configs.empty()) throw std::runtime_error("Simulator::run: no model loaded");
+  QuietScope q(quiet);
+
+  // Same starting point as a fresh perf_model process
+  freq_sa = spec.freq_ghz;
+  batch_size = spec.batch_size;
+  data_type_width = alloc_act_width = alloc_weight_width = spec.dtype_width;
+  frontend::standard::arch_config = frontend::standard::ArchConfig(spec.cores, spec.sa_sz, spec.vu_sz, spec.ws);
+  frontend::standard::mapper_config.enabled = spec.map || spec.map_verify > 0;
+  frontend::standard::mapper_config.verify_top = spec.map_verify;
+  frontend::standard::fusion_config.enabled = spec.fuse;
+  mem::setup(spec.dram_config, spec.dram_output_dir);
+  jobs_finished = 0;
+
+  RunStats stats;
+  stats.reused_graph = !jobs.empty();
+  if (stats.reused_graph) {
+    for (auto *j: jobs) j->reset();
+    total_jobs = (int) jobs.size();
+  } else {
+    alloc_addr = 0;
+    total_jobs = 0;
+    // Only this graph's LLM runs, earlier ones may point at freed jobs
+    frontend::standard::llm_runs.clear();
+    JobList built;
+    for (auto &layer: frontend::standard::StandardLayer().make_layers(configs)) {
+      built.insert(built.end(), layer.first.begin(), layer.first.end());
+    }
+    roots = built;
+    jobs = collect_jobs(roots);
+  }
+  std::unique_ptr<Arch> arch(new frontend::standard::StandardArch);
+  arch->verbose = !quiet;
+
+  TimeBasedEnqueue time_enqueues;
+  time_enqueues.enqueue_at(0, &roots);
+  uint64_t reads_before = mem::reads_done, writes_before = mem::writes_done;
+  RuntimeStats_t *res = arch->get_cycles(time_enqueues);
+
+  stats.cycles = res[0].cycles;
+  stats.time_us = (double) stats.cycles / spec.freq_ghz / 1e3;
+  stats.jobs = (int) jobs.size();
+  stats.dram_reads = mem::reads_done - reads_before;
+  stats.dram_writes = mem::writes_done - writes_before;
+  delete[] res[0].pct_active;
+  delete[] res;
+
+  for (int i = 0; i < (int) arch->states.size(); ++i) {
+    UnitStats u;
+    u.name = arch->states[i]->get_ty_string() + "_" + std::to_string(i);
+    u.active_cycles = arch->active_cycles[i];
+    u.breakdown = arch->unit_breakdown[i];
+    stats.units.push_back(u);
+  }
+
+  std::map<int, LayerStats> layers;
+  for (auto *j: arch->dispatched_jobs) {
+    auto it = layers.find(j->layer_idx);
+    if (it == layers.end()) {
+      it = layers.emplace(j->layer_idx, LayerStats()).first;
+      it->second.name = j->layer_idx >= 0 && j->layer_idx < (int) layer_names.size() ? layer_names[j->layer_idx] : "unknown";
+      it->second.start = j->start_cycle;
+    }
+    auto &l = it->second;
+    l.jobs++;
+    l.start = std::min(l.start, j->start_cycle);
+    l.finish = std::max(l.finish, j->finish_cycle);
+    l.read_stall += j->read_stall_cycles;
+    l.write_stall += j->write_stall_cycles;
+    l.bytes_read += j->bytes_read;
+    l.bytes_written += j->bytes_written;
+  }
+  for (auto &pr: layers) stats.layers.push_back(pr.second);
+
+  return stats;
+}
@@ -9,32 +9,45 @@
 
 #include "Arch.h"
 #include "State.h"
+#include "WhatIf.h"
 #include "global.h"
 
-void State::enqueue_writes() {
+void State::queue_writes() {
   // Queue memory write transactions with bandwidth limits
-  if (mem_write_left_unqueued > 0) {
-    int to_enq = std::min(dram_enq_per_cycle, mem_write_left_unqueued);
-    mem_write_left_unqueued -= to_enq;
-    mem_queued += to_enq;
-    for (int i = 0; i < to_enq; ++i) {
-      to_enqueue.emplace_back(j->addr, true, core_memory_priority, this);
-      j->addr += bytes_per_tx;
-    }
+  if (whatif_config.ideal_memory) {
+    // Zero latency and unlimited bandwidth, every write lands at once
+    j->bytes_written += (uint64_t) mem_write_left_unqueued * bytes_per_tx;
+    mem_write_left -= mem_write_left_unqueued;
+    mem_write_left_unqueued = 0;
+    return;
   }
+  int to_enq = (int) std::min<int64_t>(dram_enq_per_cycle, mem_write_left_unqueued);
+  mem_write_left_unqueued -= to_enq;
+  mem_queued += to_enq;
+  for (int i = 0; i < to_enq; ++i) {
+    tx_queue->emplace_back(j->addr, true, core_memory_priority, this);
+    j->addr += bytes_per_tx;
+  }
+  j->bytes_written += (uint64_t) to_enq * bytes_per_tx;
 }
 
-void State::enqueue_reads() {
+void State::queue_reads() {
   // Queue memory read transactions with bandwidth limits
-  if (mem_read_left_unqueued > 0) {
-    int to_enq = std::min(dram_enq_per_cycle, mem_read_left_unqueued);
-    mem_read_left_unqueued -= to_enq;
-    mem_queued += to_enq;
-    for (int i = 0; i < to_enq; ++i) {
-      to_enqueue.emplace_back(j->addr, false, core_memory_priority, this);
-      j->addr += bytes_per_tx;
-    }
+  if (whatif_config.ideal_memory) {
+    j->bytes_read += (uint64_t) mem_read_left_unqueued * bytes_per_tx;
+    if (j->first_read_cycle == 0) j->first_read_cycle = gcycles;
+    mem_read_left -= mem_read_left_unqueued;
+    mem_read_left_unqueued = 0;
+    return;
+  }
+  int to_enq = (int) std::min<int64_t>(dram_enq_per_cycle, mem_read_left_unqueued);
+  mem_read_left_unqueued -= to_enq;
+  mem_queued += to_enq;
+  for (int i = 0; i < to_enq; ++i) {
+    tx_queue->emplace_back(j->addr, false, core_memory_priority, this);
+    j->addr += bytes_per_tx;
   }
+  j->bytes_read += (uint64_t) to_enq * bytes_per_tx;
 }
 
 void State::check_idle_from_memory() {
@@ -48,6 +61,8 @@ void State::check_idle_from_memory() {
 
 bool State::process_stage() {
   // Process current stage: decrement cycle counter and check completion
+  if (whatif_config.ideal_compute)
+    min_stage_cycles = 0;
   if (min_stage_cycles > 0)
     min_stage_cycles--;
   if (min_stage_cycles == 0 && mem_read_left == 0 && mem_write_left == 0) {
@@ -57,19 +72,31 @@ bool State::process_stage() {
   return false;
 }
 
-void State::state_transfer(int st, int read_amt_bytes, int write_amt_bytes, int min_cycles) {
+void State::state_transfer(int st, int64_t read_amt_bytes, int64_t write_amt_bytes, int64_t min_cycles) {
   IFVERB(printf("Time(%llu) - Transfer from %s to %s\n", gcycles, to_string(state), to_string(st)));
   UPDATE_STATE(st);
   min_stage_cycles = min_cycles;
-  int rmin = read_amt_bytes > 0 ? 1 : 0;
-  int wmin = write_amt_bytes > 0 ? 1 : 0;
-  SET_READS(std::max(rmin, read_amt_bytes / bytes_per_tx));
-  SET_WRITES(std::max(wmin, write_amt_bytes / bytes_per_tx));
+  int64_t rmin = read_amt_bytes > 0 ? 1 : 0;
+  int64_t wmin = write_amt_bytes > 0 ? 1 : 0;
+  SET_READS(std::max<int64_t>(rmin, read_amt_bytes / bytes_per_tx));
+  SET_WRITES(std::max<int64_t>(wmin, write_amt_bytes / bytes_per_tx));
   if (is_idle_from_memory) {
     UPDATE_IDLEMEM(false);
   }
 }
 
+void State::save(std::ostream &out) {
+  out << min_stage_cycles << ' ' << mem_read_left << ' ' << mem_write_left << ' ' << mem_read_left_unqueued << ' '
+      << mem_write_left_unqueued << ' ' << mem_queued << ' ' << is_idle_from_memory << ' ' << loop_row_tiles << ' '
+      << loop_cols_tiles << ' ' << row_i << ' ' << col_i << ' ' << activation_in_buffer << ' ' << get_state() << '\n';
+}
+
+void State::load(std::istream &in) {
+  int st = 0;
+  in >> min_stage_cycles >> mem_read_left >> mem_write_left >> mem_read_left_unqueued >> mem_write_left_unqueued >>
+      mem_queued >> is_idle_from_memory >> loop_row_tiles >> loop_cols_tiles >> row_i >> col_i >> activation_in_buffer >> st;
+  set_state(st);
+}
 
 
 static int g_vcd_ctr = 0;
@@ -0,0 +1,146 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "Throughput.h"
+#include "memory.h"
+
+#include <algorithm>
+#include <cmath>
+
+ThroughputConfig throughput_config;
+
+namespace {
+  struct Iteration {
+    JobList sinks;
+    size_t sinks_done = 0;// sinks before this one have finished, later ones are checked from here
+
+    // Sinks finish for good, so every cycle only looks past the ones already seen finished
+    bool done() {
+      while (sinks_done < sinks.size() && sinks[sinks_done]->is_done) ++sinks_done;
+      return sinks_done == sinks.size();
+    }
+  };
+
+  // Iterations may overtake each other, so completions are recorded in the order they happen
+  struct Completion {
+    uint64_t cycle;
+    std::vector<uint64_t> active;// snapshot of Arch::active_cycles
+  };
+
+  JobList make_iteration(const LayerParser &layerParser, const std::vector<LayerConfig> &configs, JobList &roots) {
+    auto network = layerParser.make_layers(configs);
+    alloc_task_idx++;
+    for (auto &layer: network) roots.insert(roots.end(), layer.first.begin(), layer.first.end());
+    // Sinks are the jobs without children
+    JobList sinks;
+    for (auto *job: collect_jobs(roots)) {
+      if (job->children.empty()) sinks.push_back(job);
+    }
+    return sinks;
+  }
+}// namespace
+
+void run_throughput(Arch *arch, const LayerParser &layerParser, const std::string &model, FILE *f) {
+  const auto &cfg = throughput_config;
+  std::vector<LayerConfig> configs = layerParser.read_layers(model);
+
+  std::vector<Iteration> iters;
+  std::vector<size_t> in_flight;// indices into iters of the iterations not complete yet
+  std::vector<Completion> completions;
+  bool converged = false;
+  size_t steady_end = 0;// completion at which the intervals converged
+  std::vector<Job *> first_roots;
+  iters.push_back({make_iteration(layerParser, configs, first_roots)});
+  in_flight.push_back(0);
+
+  // Mean completion interval over the `window` intervals ending at completion `end`
+  auto mean_interval = [&](size_t end) {
+    return (double) (completions[end].cycle - completions[end - cfg.window].cycle) / (double) cfg.window;
+  };
+  // Compare the last two windows rather than single intervals, iterations in flight together can
+  // complete in a periodic but uneven pattern
+  auto intervals_converged = [&]() {
+    size_t n = completions.size();
+    if (n < 2 * (size_t) cfg.window + 1) return false;
+    double cur = mean_interval(n - 1), prev = mean_interval(n - 1 - cfg.window);
+    return cur > 0 && std::abs(cur - prev) / cur <= cfg.tolerance;
+  };
+
+  arch->cycle_hook = [&](const enqueue_job_f_t &enqueue_job) -> bool {
+    for (size_t i = 0; i < in_flight.size();) {
+      auto &it = iters[in_flight[i]];
+      if (!it.done()) {
+        ++i;
+        continue;
+      }
+      in_flight.erase(in_flight.begin() + (long) i);
+      uint64_t cycle = 0;
+      for (auto *j: it.sinks) cycle = std::max(cycle, j->finish_cycle);
+      completions.push_back({cycle, arch->active_cycles});
+      if (!converged && intervals_converged()) {
+        converged = true;
+        steady_end = completions.size() - 1;
+      }
+    }
+    const size_t n_completed = completions.size();
+    bool may_inject = !converged && (int) iters.size() < cfg.max_iters;
+    if (may_inject && arch->total_frontier == 0 && (int) (iters.size() - n_completed) < cfg.max_inflight) {
+      JobList roots;
+      iters.push_back({make_iteration(layerParser, configs, roots)});
+      in_flight.push_back(iters.size() - 1);
+      for (auto *j: roots) enqueue_job(j);
+    }
+    return may_inject || completions.size() < iters.size();
+  };
+
+  TimeBasedEnqueue time_enqueues;
+  time_enqueues.enqueue_at(0, &first_roots);
+  mem::mem_sys->ResetStats();
+  arch->get_cycles(time_enqueues);
+  arch->cycle_hook = nullptr;
+
+  if (!converged) {
+    std::cerr << "Warning: iteration cycles did not converge within " << cfg.tolerance << " after " << iters.size()
+              << " iterations, reporting the last " << cfg.window << " intervals" << std::endl;
+  }
+  const size_t n = completions.size();
+  if (!converged) steady_end = n - 1;
+  const size_t w = std::min<size_t>(cfg.window, steady_end);
+  if (w == 0) throw std::runtime_error("Throughput mode needs at least two iterations");
+
+  // Steady state: the `w` completion intervals up to convergence. Iterations still in flight then
+  // complete while the pipeline drains and are not part of it
+  const auto &first = completions[steady_end - w];
+  const auto &last = completions[steady_end];
+  double interval = (double) (last.cycle - first.cycle) / (double) w;
+  double inferences_per_s = freq_sa * 1e9 / interval;
+  uint64_t total_cycles = completions[n - 1].cycle;
+  // Fill: cycles before the steady-state line, extrapolated back to the first completion. Drain: extra
+  // cycles after convergence over what the remaining iterations would take at the steady interval,
+  // iterations in flight together can also finish sooner than that
+  double fill = (double) last.cycle - interval * (double) (steady_end + 1);
+  double drain = std::max(0., (double) (total_cycles - last.cycle) - interval * (double) (n - 1 - steady_end));
+
+  fprintf(f, "Cycles %llu\n", (unsigned long long) total_cycles);
+  fprintf(f, "Iterations %zu\n", n);
+  fprintf(f, "Converged %d\n", (int) converged);
+  fprintf(f, "SteadyCycles %f\n", interval);
+  fprintf(f, "InferencesPerSecond %f\n", inferences_per_s);
+  fprintf(f, "FillOverhead %f\n", fill);
+  fprintf(f, "DrainOverhead %f\n", drain);
+  for (int i = 0; i < (int) arch->states.size(); ++i) {
+    double busy = (double) (last.active[i] - first.active[i]);
+    fprintf(f, "%s %f\n", arch->states[i]->get_ty_string().c_str(), busy * 100. / (double) (last.cycle - first.cycle));
+  }
+
+  printf("Throughput: %zu iterations, steady state %f cycles/iteration (%f inferences/s)%s\n", n, interval,
+         inferences_per_s, converged ? "" : ", not converged");
+  printf("Pipeline fill overhead %f cycles, drain overhead %f cycles\n", fill, drain);
+  printf("Drain Ratio: %f\n", (double) completions[0].cycle / interval);
+}
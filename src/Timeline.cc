@@ -0,0 +1,137 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "Timeline.h"
+#include "Json.h"
+#include "NNLayers.h"
+#include "State.h"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+std::string timeline_file;
+
+namespace {
+  struct LayerSummary {
+    int jobs = 0;
+    uint64_t start = UINT64_MAX, finish = 0;
+    uint64_t busy = 0, read_stall = 0, write_stall = 0;
+    uint64_t bytes_read = 0, bytes_written = 0;
+  };
+
+  std::string layer_name(int idx) {
+    return idx >= 0 && idx < (int) layer_names.size() ? layer_names[idx] : "unknown";
+  }
+
+  std::string unit_name(const Arch *arch, int idx) {
+    return idx < 0 ? "none" : arch->states[idx]->get_ty_string() + "_" + std::to_string(idx);
+  }
+
+  FILE *open_or_throw(const std::string &fname) {
+    FILE *f = fopen(fname.c_str(), "w");
+    if (!f) throw std::runtime_error("Failed to open timeline file '" + fname + "'");
+    return f;
+  }
+
+  typedef unsigned long long ull;
+}// namespace
+
+void write_timeline(const Arch *arch, const std::string &fname) {
+  // Only finished jobs have a complete record
+  JobList jobs;
+  for (auto *j: arch->dispatched_jobs) {
+    if (j->is_done) jobs.push_back(j);
+  }
+
+  std::map<int, LayerSummary> layers;
+  for (auto *j: jobs) {
+    auto &l = layers[j->layer_idx];
+    l.jobs++;
+    l.start = std::min(l.start, j->start_cycle);
+    l.finish = std::max(l.finish, j->finish_cycle);
+    l.busy += j->finish_cycle - j->start_cycle;
+    l.read_stall += j->read_stall_cycles;
+    l.write_stall += j->write_stall_cycles;
+    l.bytes_read += j->bytes_read;
+    l.bytes_written += j->bytes_written;
+  }
+
+  bool as_json = fname.size() >= 5 && fname.compare(fname.size() - 5, 5, ".json") == 0;
+  if (as_json) {
+    FILE *f = open_or_throw(fname);
+    fprintf(f, "{\n  \"units\": [");
+    for (int i = 0; i < (int) arch->states.size(); ++i) {
+      const auto &bd = arch->unit_breakdown[i];
+      fprintf(f, "%s\n    {\"unit\": \"%s\", \"compute\": %llu, \"read_stall\": %llu, \"write_stall\": %llu, "
+                 "\"dependency_wait\": %llu, \"idle\": %llu}",
+              i ? "," : "", unit_name(arch, i).c_str(), (ull) bd.compute, (ull) bd.read_stall,
+              (ull) bd.write_stall, (ull) bd.dep_wait, (ull) bd.idle);
+    }
+    fprintf(f, "\n  ],\n  \"layers\": [");
+    bool first = true;
+    for (auto &pr: layers) {
+      const auto &l = pr.second;
+      fprintf(f, "%s\n    {\"layer\": \"%s\", \"jobs\": %d, \"start\": %llu, \"finish\": %llu, \"busy\": %llu, "
+                 "\"compute\": %llu, \"read_stall\": %llu, \"write_stall\": %llu, \"bytes_read\": %llu, "
+                 "\"bytes_written\": %llu}",
+              first ? "" : ",", json::escape(layer_name(pr.first)).c_str(), l.jobs, (ull) l.start, (ull) l.finish,
+              (ull) l.busy, (ull) (l.busy - l.read_stall - l.write_stall), (ull) l.read_stall, (ull) l.write_stall,
+              (ull) l.bytes_read, (ull) l.bytes_written);
+      first = false;
+    }
+    fprintf(f, "\n  ],\n  \"jobs\": [");
+    first = true;
+    for (auto *j: jobs) {
+      fprintf(f, "%s\n    {\"job\": %d, \"layer\": \"%s\", \"unit\": \"%s\", \"dims\": \"%s\", \"dispatch\": %llu, "
+                 "\"first_read\": %llu, \"finish\": %llu, \"bytes_read\": %llu, \"bytes_written\": %llu, "
+                 "\"read_stall\": %llu, \"write_stall\": %llu}",
+              first ? "" : ",", j->job_idx, json::escape(layer_name(j->layer_idx)).c_str(),
+              unit_name(arch, j->unit_idx).c_str(), json::escape(j->get_job_dims_string()).c_str(),
+              (ull) j->start_cycle, (ull) j->first_read_cycle, (ull) j->finish_cycle, (ull) j->bytes_read,
+              (ull) j->bytes_written, (ull) j->read_stall_cycles, (ull) j->write_stall_cycles);
+      first = false;
+    }
+    fprintf(f, "\n  ]\n}\n");
+    fclose(f);
+    return;
+  }
+
+  std::string stem = fname;
+  if (stem.size() >= 4 && stem.compare(stem.size() - 4, 4, ".csv") == 0) stem.resize(stem.size() - 4);
+
+  FILE *f = open_or_throw(fname);
+  fprintf(f, "job,layer,unit,dims,dispatch,first_read,finish,bytes_read,bytes_written,read_stall,write_stall\n");
+  for (auto *j: jobs) {
+    fprintf(f, "%d,%s,%s,%s,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n", j->job_idx, layer_name(j->layer_idx).c_str(),
+            unit_name(arch, j->unit_idx).c_str(), j->get_job_dims_string().c_str(), (ull) j->start_cycle,
+            (ull) j->first_read_cycle, (ull) j->finish_cycle, (ull) j->bytes_read, (ull) j->bytes_written,
+            (ull) j->read_stall_cycles, (ull) j->write_stall_cycles);
+  }
+  fclose(f);
+
+  f = open_or_throw(stem + "_layers.csv");
+  fprintf(f, "layer,jobs,start,finish,busy,compute,read_stall,write_stall,bytes_read,bytes_written\n");
+  for (auto &pr: layers) {
+    const auto &l = pr.second;
+    fprintf(f, "%s,%d,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n", layer_name(pr.first).c_str(), l.jobs,
+            (ull) l.start, (ull) l.finish, (ull) l.busy, (ull) (l.busy - l.read_stall - l.write_stall),
+            (ull) l.read_stall, (ull) l.write_stall, (ull) l.bytes_read, (ull) l.bytes_written);
+  }
+  fclose(f);
+
+  f = open_or_throw(stem + "_units.csv");
+  fprintf(f, "unit,compute,read_stall,write_stall,dependency_wait,idle\n");
+  for (int i = 0; i < (int) arch->states.size(); ++i) {
+    const auto &bd = arch->unit_breakdown[i];
+    fprintf(f, "%s,%llu,%llu,%llu,%llu,%llu\n", unit_name(arch, i).c_str(), (ull) bd.compute, (ull) bd.read_stall,
+            (ull) bd.write_stall, (ull) bd.dep_wait, (ull) bd.idle);
+  }
+  fclose(f);
+}
@@ -0,0 +1,125 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "Trace.h"
+#include "Json.h"
+#include "NNLayers.h"
+#include "State.h"
+#include "memory.h"
+
+#include <stdexcept>
+
+std::string trace_file;
+uint64_t trace_counter_cycles = 1000;
+
+static const size_t flush_bytes = 1 << 20;
+
+// Trace timestamps are in microseconds
+static std::string to_us(uint64_t cycle) {
+  char s[32];
+  snprintf(s, sizeof(s), "%.4f", (double) cycle / (freq_sa * 1e3));
+  return s;
+}
+
+ChromeTrace::ChromeTrace(const std::string &fname, Arch *arch) : arch(arch), tracks(arch->states.size()) {
+  f = fopen(fname.c_str(), "w");
+  if (!f) throw std::runtime_error("Failed to open trace file '" + fname + "'");
+  buf.reserve(flush_bytes + 4096);
+  buf += "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+  emit("{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"args\": {\"name\": \"COCOSSim\"}}");
+  for (int i = 0; i < (int) arch->states.size(); ++i) {
+    std::string name = arch->states[i]->get_ty_string() + "_" + std::to_string(i);
+    emit("{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " + std::to_string(i) +
+         ", \"args\": {\"name\": \"" + name + "\"}}");
+  }
+}
+
+ChromeTrace::~ChromeTrace() {
+  buf += "\n]}\n";
+  fwrite(buf.data(), 1, buf.size(), f);
+  fclose(f);
+}
+
+void ChromeTrace::emit(const std::string &event) {
+  buf += first_event ? "\n" : ",\n";
+  buf += event;
+  first_event = false;
+  if (buf.size() >= flush_bytes) {
+    fwrite(buf.data(), 1, buf.size(), f);
+    buf.clear();
+  }
+}
+
+void ChromeTrace::span(int tid, const std::string &name, const char *cat, uint64_t start, uint64_t end,
+                       const std::string &args) {
+  std::string e = "{\"name\": \"" + name + "\", \"cat\": \"" + cat + "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " +
+                  std::to_string(tid) + ", \"ts\": " + to_us(start) + ", \"dur\": " + to_us(end - start);
+  if (!args.empty()) e += ", \"args\": {" + args + "}";
+  emit(e + "}");
+}
+
+void ChromeTrace::sample_bandwidth(uint64_t cycle) {
+  // Completed bytes per nanosecond, i.e. GB/s
+  double ns = (double) (cycle - last_sample) / freq_sa;
+  double rd = (double) (mem::reads_done - reads_at_sample) * bytes_per_tx / ns;
+  double wr = (double) (mem::writes_done - writes_at_sample) * bytes_per_tx / ns;
+  char args[96];
+  snprintf(args, sizeof(args), "{\"read\": %.3f, \"write\": %.3f}", rd, wr);
+  emit("{\"name\": \"DRAM GB/s\", \"ph\": \"C\", \"pid\": 0, \"ts\": " + to_us(last_sample) + ", \"args\": " + args + "}");
+  last_sample = cycle;
+  reads_at_sample = mem::reads_done;
+  writes_at_sample = mem::writes_done;
+}
+
+void ChromeTrace::record_cycle(uint64_t cycle) {
+  for (int i = 0; i < (int) tracks.size(); ++i) {
+    State *state = arch->states[i];
+    auto &t = tracks[i];
+    int st = state->get_state();
+    bool stalled = state->j != nullptr && state->is_idle_from_memory;
+    if (t.stalled && (!stalled || st != t.state)) {
+      span(i, "memory stall", "stall", t.stall_start, cycle);
+      t.stalled = false;
+    }
+    if (st != t.state) {
+      if (t.state != 0) span(i, state->get_state_string(t.state), "state", t.state_start, cycle);
+      t.state = st;
+      t.state_start = cycle;
+    }
+    if (state->j != t.job) {
+      if (t.job) {
+        Job *j = t.job;
+        std::string layer = j->layer_idx >= 0 && j->layer_idx < (int) layer_names.size() ? layer_names[j->layer_idx] : "";
+        span(i, json::escape(layer.empty() ? j->get_job_dims_string() : layer), "job", t.job_start, cycle,
+             "\"job\": " + std::to_string(j->job_idx) + ", \"dims\": \"" + json::escape(j->get_job_dims_string()) +
+             "\", \"bytes_read\": " + std::to_string(j->bytes_read) +
+             ", \"bytes_written\": " + std::to_string(j->bytes_written));
+      }
+      t.job = state->j;
+      t.job_start = t.job ? t.job->start_cycle : cycle;
+    }
+    if (stalled && !t.stalled) {
+      t.stalled = true;
+      t.stall_start = cycle;
+    }
+  }
+  if (cycle >= last_sample + trace_counter_cycles) sample_bandwidth(cycle);
+}
+
+void ChromeTrace::close_spans(uint64_t cycle) {
+  // An idle, job-less state closes everything that is open
+  for (int i = 0; i < (int) tracks.size(); ++i) {
+    auto &t = tracks[i];
+    if (t.stalled) span(i, "memory stall", "stall", t.stall_start, cycle);
+    if (t.state != 0) span(i, arch->states[i]->get_state_string(t.state), "state", t.state_start, cycle);
+    if (t.job) span(i, json::escape(t.job->get_job_dims_string()), "job", t.job_start, cycle);
+    t = Track();
+  }
+  if (cycle > last_sample) sample_bandwidth(cycle);
+}
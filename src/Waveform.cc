@@ -0,0 +1,152 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "Waveform.h"
+
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+WaveformConfig waveform_config;
+WaveformWriter *waveform = nullptr;
+
+static const size_t ring_records = 1 << 20;
+static const size_t flush_bytes = 1 << 20;
+
+bool WaveformConfig::keeps_unit(int idx) const {
+  if (units.empty()) return true;
+  std::stringstream ss(units);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    auto dash = item.find('-');
+    int lo = std::stoi(item.substr(0, dash));
+    int hi = dash == std::string::npos ? lo : std::stoi(item.substr(dash + 1));
+    if (idx >= lo && idx <= hi) return true;
+  }
+  return false;
+}
+
+// Printable VCD identifiers, '!' to '~'
+static std::string signal_id(size_t n) {
+  std::string id;
+  do {
+    id += (char) ('!' + n % 94);
+    n /= 94;
+  } while (n > 0);
+  return id;
+}
+
+WaveformWriter::WaveformWriter(const std::string &fname) : ring(ring_records) {
+  f = fopen(fname.c_str(), "w");
+  if (!f) throw std::runtime_error("Failed to open waveform file '" + fname + "'");
+}
+
+WaveformWriter::~WaveformWriter() {
+  if (!window_open && gcycles >= waveform_config.from) open_window();
+  done.store(true, std::memory_order_release);
+  if (writer.joinable()) writer.join();
+  fclose(f);
+}
+
+void WaveformWriter::declare(int stat_id, const std::string &name, int width) {
+  size_t key = stat_id + 1;
+  if (key >= signal_of.size()) signal_of.resize(key + 1, -1);
+  signal_of[key] = (int) signals.size();
+  signals.push_back({name, signal_id(signals.size()), width});
+  last.push_back(0);
+}
+
+void WaveformWriter::begin() {
+  // Times are integer picoseconds so any frequency stays exact enough
+  fprintf(f, "$timescale 1ps $end\n$scope module top $end\n");
+  for (auto &s: signals) fprintf(f, "$var wire %d %s %s $end\n", s.width, s.id.c_str(), s.name.c_str());
+  fprintf(f, "$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n");
+  for (auto &s: signals) fprintf(f, "b0 %s\n", s.id.c_str());
+  fprintf(f, "$end\n");
+  // Without -vcd_from every change is dumped and the zeros above are the true start values
+  window_open = waveform_config.from == 0;
+  writer = std::thread(&WaveformWriter::drain, this);
+}
+
+void WaveformWriter::open_window() {
+  window_open = true;
+  for (size_t i = 0; i < signals.size(); ++i) push({waveform_config.from, (uint32_t) i, last[i]});
+}
+
+void WaveformWriter::push(const Record &r) {
+  size_t h = head.load(std::memory_order_relaxed);
+  // The ring is full: wait for the writer rather than grow without bound
+  while (h - tail.load(std::memory_order_acquire) >= ring.size()) std::this_thread::yield();
+  ring[h % ring.size()] = r;
+  head.store(h + 1, std::memory_order_release);
+}
+
+void WaveformWriter::drain() {
+  std::string out;
+  out.reserve(flush_bytes + 4096);
+  // Changes of the current time step, the last value of a signal wins
+  std::vector<int> pending_idx(signals.size(), -1);
+  std::vector<std::pair<uint32_t, uint64_t>> pending;
+  uint64_t cur_cycle = 0;
+  char line[96];
+
+  auto flush_step = [&]() {
+    if (pending.empty()) return;
+    int n = snprintf(line, sizeof(line), "#%llu\n", (unsigned long long) std::llround((double) cur_cycle * 1000. / freq_sa));
+    out.append(line, n);
+    for (auto &pr: pending) {
+      // Binary value without leading zeros, then the identifier
+      char bits[66];
+      int nb = 0;
+      uint64_t v = pr.second;
+      do {
+        bits[nb++] = (char) ('0' + (v & 1));
+        v >>= 1;
+      } while (v);
+      out += 'b';
+      while (nb) out += bits[--nb];
+      out += ' ';
+      out += signals[pr.first].id;
+      out += '\n';
+      pending_idx[pr.first] = -1;
+    }
+    pending.clear();
+    if (out.size() >= flush_bytes) {
+      fwrite(out.data(), 1, out.size(), f);
+      out.clear();
+    }
+  };
+
+  size_t t = tail.load(std::memory_order_relaxed);
+  while (true) {
+    size_t h = head.load(std::memory_order_acquire);
+    if (t == h) {
+      if (done.load(std::memory_order_acquire) && head.load(std::memory_order_acquire) == t) break;
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      continue;
+    }
+    for (; t != h; ++t) {
+      const Record &r = ring[t % ring.size()];
+      if (r.cycle != cur_cycle) {
+        flush_step();
+        cur_cycle = r.cycle;
+      }
+      if (pending_idx[r.signal] >= 0) {
+        pending[pending_idx[r.signal]].second = r.value;
+      } else {
+        pending_idx[r.signal] = (int) pending.size();
+        pending.emplace_back(r.signal, r.value);
+      }
+    }
+    tail.store(t, std::memory_order_release);
+  }
+  flush_step();
+  fwrite(out.data(), 1, out.size(), f);
+}
@@ -0,0 +1,146 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "WhatIf.h"
+#include "Energy.h"
+#include "NNLayers.h"
+#include "Waveform.h"
+#include "frontends/standard/LLMInference.h"
+#include "memory.h"
+
+#include <algorithm>
+#include <map>
+
+WhatIfConfig whatif_config;
+
+namespace {
+  enum Mode { BASELINE, IDEAL_MEMORY, IDEAL_COMPUTE, UNLIMITED_UNITS, N_MODES };
+  const char *mode_names[N_MODES] = {"baseline", "ideal_memory", "ideal_compute", "unlimited_units"};
+  const char *bound_names[N_MODES] = {"dependency", "bandwidth", "compute", "structural"};
+
+  // An override has to save this much of a layer's cycles before the layer counts as bound by it
+  const double min_gain = 0.1;
+
+  struct LayerSpan {
+    uint64_t start = UINT64_MAX, finish = 0;
+    uint64_t cycles() const { return finish > start ? finish - start : 0; }
+  };
+
+  struct ModeResult {
+    uint64_t cycles = 0;
+    std::map<int, LayerSpan> layers;
+  };
+
+  ModeResult run_mode(Arch *arch, JobList &roots) {
+    TimeBasedEnqueue time_enqueues;
+    time_enqueues.enqueue_at(0, &roots);
+    ModeResult res;
+    RuntimeStats_t *stats = arch->get_cycles(time_enqueues);
+    res.cycles = stats[0].cycles;
+    delete[] stats[0].pct_active;
+    delete[] stats;
+    for (auto *j: arch->dispatched_jobs) {
+      auto &l = res.layers[j->layer_idx];
+      l.start = std::min(l.start, j->start_cycle);
+      l.finish = std::max(l.finish, j->finish_cycle);
+    }
+    return res;
+  }
+
+  // The override that saves the most cycles, or BASELINE (dependency bound) if none saves enough
+  int bound_of(const uint64_t (&cycles)[N_MODES]) {
+    int best = BASELINE;
+    uint64_t best_gain = (uint64_t) ((double) cycles[BASELINE] * min_gain);
+    for (int m = IDEAL_MEMORY; m < N_MODES; ++m) {
+      uint64_t gain = cycles[BASELINE] > cycles[m] ? cycles[BASELINE] - cycles[m] : 0;
+      if (gain > best_gain) {
+        best = m;
+        best_gain = gain;
+      }
+    }
+    return best;
+  }
+}// namespace
+
+void run_whatif(Arch *arch, const make_arch_f_t &make_arch, const LayerParser &layerParser,
+                const std::string &model, FILE *f) {
+  std::vector<LayerConfig> configs = layerParser.read_layers(model);
+  WhatIfConfig saved = whatif_config;
+  WaveformWriter *saved_waveform = waveform;
+
+  ModeResult results[N_MODES];
+  size_t baseline_llm_runs = 0;
+  auto *baseline_sys = mem::mem_sys;
+  for (int m = 0; m < N_MODES; ++m) {
+    JobList roots;
+    for (auto &layer: layerParser.make_layers(configs)) roots.insert(roots.end(), layer.first.begin(), layer.first.end());
+    alloc_task_idx++;
+    // Only the baseline's LLM runs are reported, the other modes' jobs are gone after their run
+    if (m == BASELINE) {
+      baseline_llm_runs = frontend::standard::llm_runs.size();
+    } else {
+      auto &runs = frontend::standard::llm_runs;
+      runs.erase(runs.begin() + (long) baseline_llm_runs, runs.end());
+    }
+
+    whatif_config.ideal_memory = m == IDEAL_MEMORY;
+    whatif_config.ideal_compute = m == IDEAL_COMPUTE;
+    Arch *run_arch = arch;
+    if (m == UNLIMITED_UNITS) {
+      // No job ever waits for a unit if every type has one unit per job
+      std::map<int, int> jobs_per_type;
+      int units = 1;
+      for (auto *j: collect_jobs(roots)) {
+        j->core_id = -1;
+        units = std::max(units, ++jobs_per_type[j->get_type()]);
+      }
+      run_arch = make_arch(units);
+    } else if (m != BASELINE) {
+      run_arch = make_arch(0);
+    }
+    // Every mode starts on idle DRAM, the baseline's is kept for the DRAMSim3 stats printed at exit
+    if (m != BASELINE) mem::mem_sys = mem::make_system();
+    std::cout << "What-if mode: " << mode_names[m] << std::endl;
+    results[m] = run_mode(run_arch, roots);
+    // -energy reports the baseline, later runs overwrite the cycle count
+    if (m == BASELINE && !energy_config.file.empty()) snapshot_energy_run();
+    if (m != BASELINE) delete mem::mem_sys;
+    mem::mem_sys = baseline_sys;
+    if (run_arch != arch) delete run_arch;
+    // The waveform and trace only follow the baseline run
+    waveform = nullptr;
+  }
+  waveform = saved_waveform;
+  whatif_config = saved;
+
+  uint64_t totals[N_MODES];
+  for (int m = 0; m < N_MODES; ++m) totals[m] = results[m].cycles;
+  fprintf(f, "Cycles %llu\n", (unsigned long long) totals[BASELINE]);
+  for (int m = 0; m < N_MODES; ++m) fprintf(f, "WhatIf %s %llu\n", mode_names[m], (unsigned long long) totals[m]);
+
+  printf("%-32s %12s %12s %12s %12s  %s\n", "layer", mode_names[0], mode_names[1], mode_names[2], mode_names[3], "bound");
+  auto print_row = [&](const std::string &name, const uint64_t (&cycles)[N_MODES]) {
+    int bound = bound_of(cycles);
+    printf("%-32s %12llu %12llu %12llu %12llu  %s\n", name.c_str(), (unsigned long long) cycles[0],
+           (unsigned long long) cycles[1], (unsigned long long) cycles[2], (unsigned long long) cycles[3],
+           bound_names[bound]);
+    fprintf(f, "Layer %s %llu %llu %llu %llu %s\n", name.c_str(), (unsigned long long) cycles[0],
+            (unsigned long long) cycles[1], (unsigned long long) cycles[2], (unsigned long long) cycles[3],
+            bound_names[bound]);
+  };
+  for (auto &pr: results[BASELINE].layers) {
+    uint64_t cycles[N_MODES];
+    for (int m = 0; m < N_MODES; ++m) {
+      auto it = results[m].layers.find(pr.first);
+      cycles[m] = it == results[m].layers.end() ? 0 : it->second.cycles();
+    }
+    print_row(pr.first >= 0 && pr.first < (int) layer_names.size() ? layer_names[pr.first] : "unknown", cycles);
+  }
+  print_row("total", totals);
+}
@@ -0,0 +1,100 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "frontends/LayerParser.h"
+#include "global.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+static std::vector<std::string> split_tensor_list(const std::string &s) {
+  std::vector<std::string> names;
+  std::stringstream ss(s);
+  std::string name;
+  while (std::getline(ss, name, ',')) {
+    if (!name.empty()) names.push_back(name);
+  }
+  return names;
+}
+
+std::vector<LayerConfig> LayerParser::read_layers(const std::string &fname) const {
+  std::ifstream layer_stream(fname);
+  if (!layer_stream.is_open()) {
+    throw std::runtime_error("Error: Could not open layer configuration file: " + fname);
+  }
+  return parse_layers(layer_stream, fname);
+}
+
+std::vector<LayerConfig> LayerParser::parse_layers(std::istream &layer_stream, const std::string &fname) {
+  std::vector<LayerConfig> layer_configs;
+  std::vector<std::string> declared;// graph inputs from `Input` lines
+  std::string line;
+  int line_no = 0;
+  while (std::getline(layer_stream, line)) {
+    line_no++;
+    auto comment = line.find('#');
+    if (comment != std::string::npos) line.resize(comment);
+
+    std::stringstream ss(line);
+    std::string tok;
+    if (!(ss >> tok)) continue;
+    std::cout << "processing " << line << std::endl;
+
+    if (tok == "Input") {
+      size_t before = declared.size();
+      while (ss >> tok) {
+        auto names = split_tensor_list(tok);
+        declared.insert(declared.end(), names.begin(), names.end());
+      }
+      if (declared.size() == before) throw std::runtime_error(fname + ":" + std::to_string(line_no) + ": Input names no tensor");
+      continue;
+    }
+
+    LayerConfig l_config;
+    l_config.layer_type = tok;
+    while (ss >> tok) {
+      if (tok.rfind("in=", 0) == 0) {
+        auto names = split_tensor_list(tok.substr(3));
+        l_config.inputs.insert(l_config.inputs.end(), names.begin(), names.end());
+      } else if (tok.rfind("out=", 0) == 0) {
+        auto names = split_tensor_list(tok.substr(4));
+        l_config.outputs.insert(l_config.outputs.end(), names.begin(), names.end());
+      } else if (tok.rfind("dtype=", 0) == 0 || tok.rfind("wdtype=", 0) == 0) {
+        bool weights = tok[0] == 'w';
+        try {
+          (weights ? l_config.weight_width : l_config.act_width) = dtype_width(tok.substr(weights ? 7 : 6));
+        } catch (const std::runtime_error &e) {
+          throw std::runtime_error(fname + ":" + std::to_string(line_no) + ": " + e.what());
+        }
+      } else {
+        try {
+          size_t used;
+          l_config.dimensions.push_back(std::stoi(tok, &used));
+          if (used != tok.size()) throw std::invalid_argument(tok);
+        } catch (const std::out_of_range &) {
+          throw std::runtime_error(fname + ":" + std::to_string(line_no) + ": dimension " + tok + " does not fit in 32 bits");
+        } catch (const std::logic_error &) {
+          throw std::runtime_error(fname + ":" + std::to_string(line_no) + ": unexpected token '" + tok + "'");
+        }
+        if (l_config.dimensions.back() < 0) {
+          throw std::runtime_error(fname + ":" + std::to_string(line_no) + ": negative dimension " + tok);
+        }
+      }
+    }
+    if (l_config.dimensions.empty()) {
+      throw std::runtime_error(fname + ":" + std::to_string(line_no) + ": layer '" + l_config.layer_type + "' has no dimensions");
+    }
+    for (const auto &t: l_config.inputs) {
+      if (std::find(declared.begin(), declared.end(), t) != declared.end()) l_config.graph_inputs.push_back(t);
+    }
+    layer_configs.push_back(l_config);
+  }
+  return layer_configs;
+}
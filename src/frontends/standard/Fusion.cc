@@ -0,0 +1,134 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "frontends/standard/Fusion.h"
+#include "global.h"
+#include "units/standard/SysArray.h"
+#include "units/standard/VectorUnit.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace frontend::standard;
+
+FusionConfig frontend::standard::fusion_config;
+FusionStats frontend::standard::fusion_stats;
+
+namespace {
+  bool is_gemm(const LayerConfig &l) { return l.layer_type == "Matmul" || l.layer_type == "Conv"; }
+
+  // Elements of the layer's output, -1 for layers that are never fused as producers
+  int64_t output_elems(const LayerConfig &l) {
+    const auto &d = l.dimensions;
+    if (l.layer_type == "Matmul") {
+      if (d.size() == 3) return (int64_t) d[0] * d[2];
+      if (d.size() == 4) return (int64_t) d[0] * d[1] * d[3];
+    } else if (l.layer_type == "Conv" && d.size() >= 5) {
+      int kernel = d.size() > 5 ? d[5] : 3, stride = d.size() > 6 ? d[6] : 1, padding = d.size() > 7 ? d[7] : 1;
+      int64_t out_h = (d[2] + 2 * padding - kernel) / stride + 1;
+      int64_t out_w = (d[3] + 2 * padding - kernel) / stride + 1;
+      return (int64_t) d[0] * out_h * out_w * d[4];
+    } else if (l.layer_type == "Add") {
+      int64_t n = 1;
+      for (int v: d) n *= v;
+      return n;
+    } else if (l.layer_type == "Softmax") {
+      if (d.size() == 1) return (int64_t) d[0] * d[0];
+      if (d.size() == 2) return (int64_t) d[0] * d[1] * d[1];
+      if (d.size() == 3) return (int64_t) d[0] * d[1] * d[2];
+    }
+    return -1;
+  }
+
+  // `first_input` is whether the producer's tensor is the consumer's first input
+  bool fusable(const LayerConfig &p, const LayerConfig &c, bool first_input) {
+    if (is_gemm(p) && (c.layer_type == "Activation" || c.layer_type == "Add")) return true;
+    if (p.layer_type == "Add" && c.layer_type == "LayerNorm") return true;
+    if (p.layer_type == "Matmul" && c.layer_type == "Softmax") return true;
+    // A systolic array job takes only its activations from the buffer
+    return p.layer_type == "Softmax" && c.layer_type == "Matmul" && first_input && c.inputs_on_chip == 0;
+  }
+
+  int width_of(const LayerConfig &l) { return l.act_width > 0 ? l.act_width : data_type_width; }
+
+  std::string name_of(const LayerConfig &l, int i) {
+    return std::to_string(i) + ":" + l.layer_type + (l.outputs.empty() ? "" : ":" + l.outputs[0]);
+  }
+}// namespace
+
+std::vector<LayerConfig> frontend::standard::fuse_layers(const std::vector<LayerConfig> &configs, int n_cores, bool verbose) {
+  std::vector<LayerConfig> out = configs;
+  const int n = (int) out.size();
+
+  // The edges connectLayerGraph() builds, with each consumer's inputs in order
+  std::unordered_map<std::string, int> producer;
+  for (int i = 0; i < n; ++i) {
+    for (const auto &t: out[i].outputs) producer.emplace(t, i);
+  }
+  std::vector<std::vector<int>> consumers(n);
+  std::vector<int> first_parent(n, -1);// producer of the first input, -1 for a graph input
+  for (int i = 0; i < n; ++i) {
+    std::vector<int> parents;
+    if (out[i].inputs.empty()) {
+      if (i > 0) parents.push_back(i - 1);
+      first_parent[i] = i - 1;
+    } else {
+      for (size_t k = 0; k < out[i].inputs.size(); ++k) {
+        auto it = producer.find(out[i].inputs[k]);
+        int p = it == producer.end() || it->second >= i ? -1 : it->second;
+        if (k == 0) first_parent[i] = p;
+        if (p >= 0 && std::find(parents.begin(), parents.end(), p) == parents.end()) parents.push_back(p);
+      }
+    }
+    for (int p: parents) consumers[p].push_back(i);
+  }
+
+  for (int p = 0; p < n; ++p) {
+    if (consumers[p].size() != 1) continue;
+    int c = consumers[p][0];
+    if (!fusable(out[p], out[c], first_parent[c] == p)) continue;
+    if (width_of(out[p]) != width_of(out[c])) continue;
+    int64_t elems = output_elems(out[p]);
+    if (elems <= 0) continue;
+    uint64_t bytes = (uint64_t) elems * width_of(out[p]) * batch_size;
+    if (div_ru((int64_t) bytes, std::max(1, n_cores)) > buffer_size_bytes) continue;
+
+    out[p].output_on_chip = true;
+    out[c].inputs_on_chip++;
+    fusion_stats.fused++;
+    fusion_stats.write_bytes += bytes;
+    fusion_stats.read_bytes += bytes;
+    if (verbose) {
+      std::cout << "Fused " << name_of(out[p], p) << " -> " << name_of(out[c], c) << ", " << bytes
+                << " bytes kept on chip" << std::endl;
+    }
+  }
+  return out;
+}
+
+void frontend::standard::apply_fusion(const LayerConfig &config, const JobPair &jobs) {
+  if (config.output_on_chip) {
+    // The layer's last jobs hold the output, e.g. the reductions of a split-K GEMM, whose
+    // partial sums still go through DRAM
+    for (auto *job: jobs.second) job->writes_output = false;
+  }
+  if (config.inputs_on_chip == 0) return;
+  for (auto *job: jobs.first) {
+    if (auto *sa = dynamic_cast<SystolicArray::SysArrayJob *>(job)) {
+      sa->act_prebuffered = true;
+    } else if (auto *vu = dynamic_cast<VectorUnit::VecUnitJob *>(job)) {
+      // Operands that still come from DRAM are streamed in as before, within the bytes Add reserved
+      vu->n_operands -= config.inputs_on_chip;
+      if (vu->n_operands <= 0) {
+        vu->n_operands = 1;
+        vu->is_prebuffered = true;
+      }
+    }
+  }
+}
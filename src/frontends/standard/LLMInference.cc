@@ -0,0 +1,89 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "frontends/standard/LLMInference.h"
+#include <algorithm>
+
+using namespace frontend::standard;
+
+std::vector<LLMRun> frontend::standard::llm_runs;
+
+static LayerConfig layer(const std::string &ty, const std::vector<int> &dims,
+                         const std::vector<std::string> &inputs, const std::string &output) {
+  LayerConfig l(std::string(ty), dims);
+  l.inputs = inputs;
+  l.outputs = {output};
+  // `x`, the hidden states a pass starts from, is the only graph input
+  if (std::find(inputs.begin(), inputs.end(), "x") != inputs.end()) l.graph_inputs = {"x"};
+  return l;
+}
+
+std::vector<LayerConfig> frontend::standard::llm_pass_layers(const LLMConfig &cfg, int tokens, int past) {
+  const int T = tokens, H = cfg.hidden, h = cfg.heads, d = cfg.hidden / cfg.heads, F = cfg.ffn_dim;
+  const int ctx = past + tokens;
+  std::vector<LayerConfig> layers;
+  for (int l = 0; l < cfg.n_layers; ++l) {
+    auto t = [&](const char *nm) { return "l" + std::to_string(l) + "." + nm; };
+    std::string x = l == 0 ? "x" : "l" + std::to_string(l - 1) + ".out";
+
+    layers.push_back(layer("LayerNorm", {T, H}, {x}, t("ln1")));
+    layers.push_back(layer("Matmul", {T, H, 3 * H}, {t("ln1")}, t("qkv")));
+    layers.push_back(layer("KVCacheWrite", {T, H}, {t("qkv")}, t("kv_new")));
+    // The attention matmuls stream the cached K and V in as their weight operands
+    std::vector<std::string> kv = {t("qkv")};
+    layers.push_back(layer("Matmul", {h, T, d, ctx}, kv, t("scores")));
+    layers.push_back(layer("Softmax", {h, T, ctx}, {t("scores")}, t("probs")));
+    kv[0] = t("probs");
+    layers.push_back(layer("Matmul", {h, T, ctx, d}, kv, t("ctx")));
+    layers.push_back(layer("Matmul", {T, H, H}, {t("ctx")}, t("attn")));
+    layers.push_back(layer("Add", {T, H}, {x, t("attn")}, t("h")));
+    layers.push_back(layer("LayerNorm", {T, H}, {t("h")}, t("ln2")));
+    layers.push_back(layer("Matmul", {T, H, F}, {t("ln2")}, t("ff1")));
+    layers.push_back(layer("Activation", {T, F}, {t("ff1")}, t("ff1_act")));
+    layers.push_back(layer("Matmul", {T, F, H}, {t("ff1_act")}, t("ff2")));
+    layers.push_back(layer("Add", {T, H}, {t("h"), t("ff2")}, t("out")));
+  }
+  return layers;
+}
+
+static uint64_t max_finish(const JobList &jobs) {
+  uint64_t c = 0;
+  for (auto *j: jobs) c = std::max(c, j->finish_cycle);
+  return c;
+}
+
+void frontend::standard::report_llm_runs(FILE *f, double ns_per_cycle) {
+  for (int r = 0; r < (int) llm_runs.size(); ++r) {
+    const auto &run = llm_runs[r];
+    uint64_t start = UINT64_MAX;
+    for (auto *j: run.prefill_roots) start = std::min(start, j->start_cycle);
+
+    uint64_t ttft = max_finish(run.pass_sinks[0]) - start;
+    std::vector<uint64_t> per_token;
+    for (int i = 1; i < (int) run.pass_sinks.size(); ++i) {
+      per_token.push_back(max_finish(run.pass_sinks[i]) - max_finish(run.pass_sinks[i - 1]));
+    }
+
+    printf("LLM %d: TTFT %llu cycles (%f us)", r, (unsigned long long) ttft, ttft * ns_per_cycle / 1000);
+    fprintf(f, "LLM %d TTFT %llu\n", r, (unsigned long long) ttft);
+    if (!per_token.empty()) {
+      uint64_t sum = 0;
+      for (auto c: per_token) sum += c;
+      double mean = (double) sum / (double) per_token.size();
+      auto mm = std::minmax_element(per_token.begin(), per_token.end());
+      printf(", per-token mean %f cycles (%f us), min %llu, max %llu over %zu decode steps",
+             mean, mean * ns_per_cycle / 1000, (unsigned long long) *mm.first, (unsigned long long) *mm.second, per_token.size());
+      fprintf(f, "LLM %d TPOT %f\n", r, mean);
+      for (int i = 0; i < (int) per_token.size(); ++i) {
+        fprintf(f, "LLM %d Token %d %llu\n", r, i + 1, (unsigned long long) per_token[i]);
+      }
+    }
+    printf("\n");
+  }
+}
@@ -0,0 +1,378 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "frontends/standard/Mapper.h"
+#include "NNLayers.h"
+#include "Profiler.h"
+#include "Waveform.h"
+#include "global.h"
+#include "memory.h"
+#include "units/standard/SysArray.h"
+#include "units/standard/VectorUnit.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+using namespace frontend::standard;
+
+MapperConfig frontend::standard::mapper_config;
+
+namespace {
+  // Layers of the same shape, precision, machine and DRAM share their mapping, e.g. the passes
+  // of an LLM. The DRAM config is one of mem::setup()'s parsed configs, which live as long as the process.
+  using MappingKey = std::tuple<int, int, int, int, int, int, int, int, bool, int, const dramsim3::Config *>;
+  std::map<MappingKey, GemmMapping> chosen_mappings;
+}// namespace
+
+namespace {
+  // Share of `part` out of `parts` near-equal shares of an extent, the first ones take the remainder
+  int64_t share(int64_t extent, int parts, int part) { return extent / parts + (part < extent % parts); }
+
+  int split_extent(GemmSplit split, int M, int K, int N) {
+    return split == GemmSplit::M ? M : split == GemmSplit::K ? K : N;
+  }
+
+  // Calls f(core, m, k, n) for every job of the mapping, in the order a core runs them
+  void for_each_job(const GemmMapping &mp, int M, int K, int N, const std::function<void(int, int, int, int)> &f) {
+    int extent = split_extent(mp.split, M, K, N);
+    for (int core = 0; core < mp.cores; ++core) {
+      int part = (int) share(extent, mp.cores, core);
+      int rows = mp.split == GemmSplit::M ? part : M;
+      int cols = mp.split == GemmSplit::N ? part : N;
+      int k = mp.split == GemmSplit::K ? part : K;
+      for (int r = 0; r < rows; r += mp.m_tile) {
+        for (int c = 0; c < cols; c += mp.n_tile) f(core, std::min(mp.m_tile, rows - r), k, std::min(mp.n_tile, cols - c));
+      }
+    }
+  }
+
+  // Calls f(elems) for every reduction job of a split-K mapping. The output is divided between
+  // the vector units, each adds up its slice of the partial sums of all cores.
+  void for_each_reduction(const GemmMapping &mp, int M, int N, const std::function<void(int64_t)> &f) {
+    if (mp.split != GemmSplit::K || mp.cores < 2) return;
+    for (int v = 0; v < mp.cores; ++v) {
+      int64_t elems = share((int64_t) M * N, mp.cores, v);
+      if (elems > 0) f(elems);
+    }
+  }
+
+  // Tile sizes for an extent: the whole of it, or power-of-two multiples of the array size below it
+  std::vector<int> tile_sizes(int extent, int sz) {
+    std::vector<int> out = {extent};
+    for (int64_t t = sz; t < extent; t *= 2) out.push_back((int) t);
+    return out;
+  }
+
+  bool ws_fits(int64_t m, int64_t n, int K, int sz) {
+    return (m * n + m * std::min(K, sz)) * batch_size * alloc_act_width <= buffer_size_bytes;
+  }
+
+  // The fixed heuristics' N split as a searchable mapping: N divided between all cores, then OS
+  // jobs of up to one array height and WS jobs as wide as the buffer allows
+  GemmMapping fixed_split(const ArchConfig &a_config, int M, int K, int N) {
+    GemmMapping mp;
+    mp.cores = std::min(a_config.n_cores, N);
+    int core_n = (int) div_ru(N, mp.cores);// the widest block
+    if (a_config.ws) {
+      mp.m_tile = M;
+      mp.n_tile = ws_fits(M, core_n, K, a_config.sa_sz_allo)
+                      ? core_n
+                      : (int) std::max<int64_t>(1, buffer_size_bytes / ((int64_t) alloc_act_width * M * batch_size));
+    } else {
+      mp.m_tile = std::min(M, a_config.sa_sz_allo);
+      mp.n_tile = core_n;
+    }
+    return mp;
+  }
+
+  // Calls f(core, m, k, n) for every job the layer builders make without the mapper (-map 0). Their
+  // OS jobs are max(1, M / sz) jobs one array tall, which pads a shorter M up to the array and
+  // leaves out the rows past the last full tile.
+  void for_each_fixed_job(const ArchConfig &a_config, int M, int K, int N, const std::function<void(int, int, int, int)> &f) {
+    const int sz = a_config.sa_sz_allo;
+    for (int core = 0; core < a_config.n_cores; ++core) {
+      int core_n = (int) share(N, a_config.n_cores, core);
+      if (core_n == 0) continue;
+      if (!a_config.ws) {
+        for (int j = 0; j < std::max(1, M / sz); ++j) f(core, sz, K, core_n);
+        continue;
+      }
+      int n_per_job = ws_fits(M, core_n, K, sz)
+                          ? core_n
+                          : (int) std::max<int64_t>(1, buffer_size_bytes / ((int64_t) alloc_act_width * M * batch_size));
+      for (int c = 0; c < core_n; c += n_per_job) f(core, M, K, std::min(n_per_job, core_n - c));
+    }
+  }
+
+  // The cost model follows the stages of the systolic array's state machine. A stage takes its
+  // compute cycles or the time to read its bytes at the unit's share of DRAM bandwidth plus one
+  // read latency, whichever is longer. Every core that gets a block is assumed to stream at once.
+  struct CostModel {
+    int sz, fpu, batch;
+    double tx_per_cycle;
+    double latency;
+
+    CostModel(const ArchConfig &a_config, int active_cores)
+        : sz(a_config.sa_sz_allo),
+          fpu(std::max(1, systolic_fpu_latency * std::max(alloc_act_width, alloc_weight_width) / 2)),
+          batch(batch_size) {
+      auto *dram = mem::dramsim3config;
+      // DRAM cycles per accelerator cycle, as the main loop ticks them
+      double dram_ticks = dram->tCK / freq_sa;
+      double peak = dram->channels * dram_ticks / std::max(1, dram->burst_cycle);
+      double machine = std::min<double>(dram_enq_per_cycle, peak);
+      tx_per_cycle = std::min<double>(dram_enq_per_cycle, machine / std::max(1, active_cores));
+      latency = dram->read_delay / dram_ticks;
+    }
+
+    double mem(int64_t bytes) const {
+      return bytes <= 0 ? 0 : std::max<int64_t>(1, bytes / bytes_per_tx) / tx_per_cycle;
+    }
+
+    double read(int64_t bytes) const { return bytes <= 0 ? 0 : mem(bytes) + latency; }
+
+    // A vector unit adding up `parts` partial sums of `elems` outputs
+    double reduce(int64_t elems, int parts, int vu_sz) const {
+      int64_t bytes = elems * alloc_act_width * batch;
+      return 1 + std::max<double>(div_ru(elems * (parts - 1), vu_sz), read(bytes * parts)) + mem(bytes);
+    }
+
+    double job(int64_t m, int64_t k, int64_t n, bool ws) const {
+      double t = 1;// dispatch
+      if (ws) {
+        int64_t lat = std::max(fpu, batch);
+        int64_t kt = std::min<int64_t>(sz, k), nt = std::min<int64_t>(sz, n);
+        int64_t rows = div_ru(k, sz), cols = div_ru(n, sz);
+        t += std::max<double>(sz, read(kt * m * alloc_act_width + nt * kt * alloc_weight_width));
+        t += rows * cols * (m * lat + std::max<double>(sz * lat, read(kt * nt * alloc_weight_width)) + 1);
+        t += (rows - 1) * read(kt * m * batch * alloc_act_width);
+        t += mem(m * n * alloc_act_width * batch);
+      } else {
+        int64_t rows = std::max<int64_t>(m / sz, 1), cols = std::max<int64_t>(n / sz, 1);
+        int64_t mt = std::min<int64_t>(sz, m);
+        double first = read(mt * k * (batch * alloc_act_width + alloc_weight_width));
+        double next = read(mt * k * alloc_weight_width);
+        double tail = sz * std::min(fpu, batch) + mem(std::max<int64_t>((int64_t) sz * sz * alloc_act_width * batch, bytes_per_tx)) + 2;
+        t += std::max<double>(k * std::max(fpu, batch), first) + tail;
+        t += (rows - 1) * (std::max<double>(k * fpu, first) + tail);
+        t += rows * (cols - 1) * (std::max<double>(k * fpu, next) + tail);
+      }
+      return t;
+    }
+  };
+
+  // Cost model estimate of the jobs -map 0 builds
+  uint64_t estimate_fixed(const ArchConfig &a_config, int M, int K, int N) {
+    CostModel model(a_config, std::min(a_config.n_cores, N));
+    std::vector<double> per_core(a_config.n_cores, 0);
+    for_each_fixed_job(a_config, M, K, N, [&](int core, int m, int k, int n) { per_core[core] += model.job(m, k, n, a_config.ws); });
+    return (uint64_t) *std::max_element(per_core.begin(), per_core.end());
+  }
+
+  // Bytes a reduction job streams from its address on, every core's partials and the sums
+  int64_t reduce_bytes(int64_t elems, int parts) { return elems * alloc_act_width * batch_size * (parts + 1); }
+
+  // Simulates the mapping's jobs alone on a fresh machine and a scratch DRAM system. Everything
+  // the run touches is put back, the layers built so far and the main run see no trace of it.
+  uint64_t simulate(const ArchConfig &a_config, const GemmMapping &mp, int M, int K, int N) {
+    uint64_t saved_addr = alloc_addr, saved_cycles = gcycles;
+    uint64_t saved_reads = mem::reads_done, saved_writes = mem::writes_done;
+    int saved_total = total_jobs, saved_finished = jobs_finished, saved_layer = alloc_layer_idx;
+    int saved_progress = prof::progress_interval_ms;
+    auto *saved_waveform = waveform;
+    auto *saved_sys = mem::mem_sys;
+    alloc_layer_idx = -1;
+    prof::progress_interval_ms = 0;
+    waveform = nullptr;
+    mem::mem_sys = mem::make_system();
+
+    std::vector<int> task_counters;
+    JobPair jobs = build_gemm(a_config, mp, M, K, N, task_counters);
+    uint64_t cycles;
+    {
+      StandardArch trial;
+      trial.verbose = false;
+      TimeBasedEnqueue time_enqueues;
+      time_enqueues.enqueue_at(0, &jobs.first);
+      RuntimeStats_t *res = trial.get_cycles(time_enqueues);
+      cycles = res[0].cycles;
+      delete[] res[0].pct_active;
+      delete[] res;
+    }
+    for (auto *j: jobs.first) delete j;
+    if (jobs.second != jobs.first) {
+      for (auto *j: jobs.second) delete j;
+    }
+
+    delete mem::mem_sys;
+    mem::mem_sys = saved_sys;
+    waveform = saved_waveform;
+    prof::progress_interval_ms = saved_progress;
+    alloc_layer_idx = saved_layer;
+    jobs_finished = saved_finished;
+    total_jobs = saved_total;
+    mem::reads_done = saved_reads;
+    mem::writes_done = saved_writes;
+    gcycles = saved_cycles;
+    alloc_addr = saved_addr;
+    return cycles;
+  }
+}// namespace
+
+int64_t frontend::standard::gemm_job_bytes(int64_t m, int64_t k, int64_t n, int sz, bool ws) {
+  int64_t aw = alloc_act_width, ww = alloc_weight_width;
+  if (ws) {
+    int64_t kt = std::min<int64_t>(sz, k), nt = std::min<int64_t>(sz, n);
+    int64_t rows = div_ru(k, sz), cols = div_ru(n, sz);
+    return kt * m * aw + nt * kt * ww + rows * cols * kt * nt * ww + (rows - 1) * kt * m * batch_size * aw +
+           m * n * aw * batch_size;
+  }
+  int64_t rows = std::max<int64_t>(m / sz, 1), cols = std::max<int64_t>(n / sz, 1);
+  int64_t mt = std::min<int64_t>(sz, m);
+  int64_t wb = std::max<int64_t>((int64_t) sz * sz * aw * batch_size, bytes_per_tx);
+  return rows * (mt * k * (batch_size * aw + ww) + (cols - 1) * mt * k * ww + cols * wb);
+}
+
+std::string GemmMapping::describe() const {
+  const char *dim = split == GemmSplit::M ? "M" : split == GemmSplit::K ? "K" : "N";
+  return std::string("split ") + dim + " over " + std::to_string(cores) + " cores, " + std::to_string(m_tile) + "x" +
+         std::to_string(n_tile) + " tiles, " + std::to_string(jobs) + " jobs" +
+         (reduce_jobs ? " + " + std::to_string(reduce_jobs) + " reductions" : "");
+}
+
+uint64_t frontend::standard::estimate_gemm(const ArchConfig &a_config, const GemmMapping &mapping, int M, int K, int N) {
+  CostModel model(a_config, mapping.cores);
+  std::vector<double> per_core(mapping.cores, 0);
+  for_each_job(mapping, M, K, N, [&](int core, int m, int k, int n) { per_core[core] += model.job(m, k, n, a_config.ws); });
+  // The reductions start once every core is done and run side by side on the vector units
+  double reduce = 0;
+  for_each_reduction(mapping, M, N, [&](int64_t elems) {
+    reduce = std::max(reduce, model.reduce(elems, mapping.cores, a_config.vu_sz_allo));
+  });
+  return (uint64_t) (*std::max_element(per_core.begin(), per_core.end()) + reduce);
+}
+
+std::vector<GemmMapping> frontend::standard::gemm_candidates(const ArchConfig &a_config, int M, int K, int N) {
+  const int sz = a_config.sa_sz_allo;
+  std::vector<GemmMapping> out = {fixed_split(a_config, M, K, N)};
+  for (GemmSplit split: {GemmSplit::N, GemmSplit::M, GemmSplit::K}) {
+    int extent = split_extent(split, M, K, N);
+    // Split-K only pays off when its partial sums can be spread over more than one core
+    if (split == GemmSplit::K && std::min(a_config.n_cores, extent) < 2) continue;
+    GemmMapping mp;
+    mp.split = split;
+    mp.cores = std::min(a_config.n_cores, extent);
+    // The largest block of a core
+    int block = (int) div_ru(extent, mp.cores);
+    int rows = split == GemmSplit::M ? block : M, cols = split == GemmSplit::N ? block : N;
+    int k = split == GemmSplit::K ? block : K;
+    for (int m_tile: tile_sizes(rows, sz)) {
+      std::vector<int> n_tiles = tile_sizes(cols, sz);
+      if (a_config.ws) {
+        // The widest job that still fits next to the activations
+        int64_t fit = buffer_size_bytes / ((int64_t) batch_size * alloc_act_width * m_tile) - std::min(k, sz);
+        if (fit >= sz) fit -= fit % sz;
+        if (fit >= 1 && fit < cols) n_tiles.push_back((int) fit);
+      }
+      for (int n_tile: n_tiles) {
+        if (a_config.ws && !ws_fits(m_tile, n_tile, k, sz)) continue;
+        mp.m_tile = m_tile;
+        mp.n_tile = n_tile;
+        out.push_back(mp);
+      }
+    }
+  }
+  // The fixed split may also be one of the searched mappings
+  auto same = [](const GemmMapping &a, const GemmMapping &b) {
+    return std::make_tuple(a.split, a.cores, a.m_tile, a.n_tile) == std::make_tuple(b.split, b.cores, b.m_tile, b.n_tile);
+  };
+  if (std::find_if(out.begin() + 1, out.end(), [&](const GemmMapping &mp) { return same(mp, out[0]); }) != out.end()) {
+    out.erase(out.begin());
+  }
+  for (auto &mp: out) {
+    mp.jobs = mp.reduce_jobs = 0;
+    for_each_job(mp, M, K, N, [&](int, int, int, int) { mp.jobs++; });
+    for_each_reduction(mp, M, N, [&](int64_t) { mp.reduce_jobs++; });
+    mp.estimate = estimate_gemm(a_config, mp, M, K, N);
+  }
+  // Fewer, larger jobs break ties
+  std::stable_sort(out.begin(), out.end(), [](const GemmMapping &a, const GemmMapping &b) {
+    return std::make_pair(a.estimate, a.jobs + a.reduce_jobs) < std::make_pair(b.estimate, b.jobs + b.reduce_jobs);
+  });
+  return out;
+}
+
+JobPair frontend::standard::build_gemm(const ArchConfig &a_config, const GemmMapping &mapping, int M, int K, int N, std::vector<int> &task_counters) {
+  JobList jobs;
+  task_counters.resize(std::max<size_t>(task_counters.size(), mapping.cores));
+  for_each_job(mapping, M, K, N, [&](int core, int m, int k, int n) {
+    auto job = new SystolicArray::SysArrayJob(m, k, n);
+    job->core_id = core;
+    job->task_idx = task_counters[core]++;
+    // A job's allocation is sized for jobs one array tall, other shapes would stream on into the
+    // next job's addresses, and units waiting on the same address lose each other's completions
+    alloc_addr = std::max<uint64_t>(alloc_addr, job->addr_hold + gemm_job_bytes(m, k, n, a_config.sa_sz_allo, a_config.ws));
+    jobs.push_back(job);
+  });
+
+  // Each reduction reads its slice of every core's partials and writes the sums, the vector
+  // units pick them up as they come free
+  JobList reductions;
+  for_each_reduction(mapping, M, N, [&](int64_t elems) {
+    if (elems > INT32_MAX) {
+      throw std::runtime_error("Error: split-K reduction of " + std::to_string(elems) + " elements does not fit in a vector unit job");
+    }
+    auto job = new VectorUnit::VecUnitJob(1, (int) elems, false, {{VectorUnit::VPUPhase::BROADCAST, mapping.cores - 1}});
+    job->n_operands = mapping.cores;
+    alloc_addr = std::max<uint64_t>(alloc_addr, job->addr_hold + reduce_bytes(elems, mapping.cores));
+    reductions.push_back(job);
+  });
+  if (reductions.empty()) return {jobs, jobs};
+  connectJobLists(jobs, reductions);
+  return {jobs, reductions};
+}
+
+JobPair frontend::standard::map_gemm(const ArchConfig &a_config, const LayerConfig &l_config, int M, int K, int N) {
+  static std::vector<int> core_task_counters;
+
+  if (M < 1 || K < 1 || N < 1) {
+    throw std::runtime_error("Error: layer '" + l_config.layer_type + "' has an empty GEMM dimension, nothing to map");
+  }
+  std::string name = alloc_layer_idx >= 0 && alloc_layer_idx < (int) layer_names.size() ? layer_names[alloc_layer_idx] : l_config.layer_type;
+  uint64_t fixed_estimate = estimate_fixed(a_config, M, K, N);
+
+  MappingKey key{M, K, N, a_config.n_cores, a_config.sa_sz_allo, batch_size, alloc_act_width,
+                 alloc_weight_width, a_config.ws, mapper_config.verify_top, mem::dramsim3config};
+  auto it = chosen_mappings.find(key);
+  if (it == chosen_mappings.end()) {
+    auto candidates = gemm_candidates(a_config, M, K, N);
+    GemmMapping best = candidates.front();
+    int n_verify = std::min<int>(mapper_config.verify_top, (int) candidates.size());
+    for (int i = 0; i < n_verify; ++i) {
+      auto &c = candidates[i];
+      c.measured = simulate(a_config, c, M, K, N);
+      std::cout << "  Mapper candidate " << i + 1 << ": " << c.describe() << ", est " << c.estimate
+                << " cycles, simulated " << c.measured << " cycles" << std::endl;
+      if (i == 0 || c.measured < best.measured) best = c;
+    }
+    it = chosen_mappings.emplace(key, best).first;
+  }
+  const GemmMapping &best = it->second;
+  std::cout << "Mapper: " << name << " " << M << "x" << K << "x" << N << ": " << best.describe() << ", est "
+            << best.estimate << " cycles" << (best.measured ? ", simulated " + std::to_string(best.measured) + " cycles" : "")
+            << " (fixed split est " << fixed_estimate << " cycles)" << std::endl;
+
+  core_task_counters.resize(std::max<size_t>(core_task_counters.size(), a_config.n_cores));
+  return build_gemm(a_config, best, M, K, N, core_task_counters);
+}
+
+void frontend::standard::clear_mappings() { chosen_mappings.clear(); }
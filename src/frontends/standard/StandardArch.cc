@@ -10,10 +10,21 @@
 #include "frontends/standard/StandardArch.h"
 #include "units/standard/SysArray.h"
 #include "units/standard/VectorUnit.h"
+#include <algorithm>
 
 using namespace frontend::standard;
 
 StandardArch::StandardArch() {
-  for (int i = 0; i < arch_config.n_cores; ++i) states.push_back(new SystolicArray::SysArrayState(arch_config.sa_sz_allo, arch_config.ws));
-  for (int i = 0; i < arch_config.n_cores; ++i) states.push_back(new VectorUnit::VecUnitState(arch_config.vu_sz_allo));
+  for (int i = 0; i < arch_config.n_cores; ++i) sys_arrays.push_back(new SystolicArray::SysArrayState(arch_config.sa_sz_allo, arch_config.ws));
+  for (int i = 0; i < arch_config.n_cores; ++i) vec_units.push_back(new VectorUnit::VecUnitState(arch_config.vu_sz_allo));
+  states.insert(states.end(), sys_arrays.begin(), sys_arrays.end());
+  states.insert(states.end(), vec_units.begin(), vec_units.end());
+}
+
+void StandardArch::increment_units(int begin, int end, StepLane *lane) {
+  // Units added to `states` after construction are only known to the generic loop
+  if (states.size() != sys_arrays.size() + vec_units.size()) return Arch::increment_units(begin, end, lane);
+  int n_sa = (int) sys_arrays.size();
+  for (int i = begin; i < std::min(end, n_sa); ++i) increment_unit(i, sys_arrays[i], lane);
+  for (int i = std::max(begin, n_sa); i < end; ++i) increment_unit(i, vec_units[i - n_sa], lane);
 }
\ No newline at end of file
@@ -8,31 +8,55 @@
  */
 
 #include "NNLayers.h"
+#include "frontends/standard/Fusion.h"
+#include "frontends/standard/LLMInference.h"
+#include "frontends/standard/Mapper.h"
 #include "frontends/standard/StandardLayer.h"
 #include "global.h"
 #include "units/standard/SysArray.h"
 #include "units/standard/VectorUnit.h"
 #include <frontends/standard/StandardArch.h>
 
+#include <climits>
 #include <functional>
 #include <stdexcept>
 #include <cmath>
 
 using namespace frontend::standard;
 
-JobList createSAJobs(int m, int k, int n, int num_jobs, int n_cores = 1) {
+// A size derived from a layer's dimensions, checked to fit a job dimension. Byte counts built from
+// job dimensions are 64-bit, so only the dimensions themselves are limited.
+static int job_dim(int64_t v, const LayerConfig &l_config) {
+  if (v < 0 || v > INT_MAX) {
+    throw std::runtime_error("Error: layer '" + l_config.layer_type + "' has a dimension of " + std::to_string(v) +
+                             ", jobs support up to " + std::to_string(INT_MAX));
+  }
+  return (int) v;
+}
+
+// A job's allocation is sized for jobs one array tall, e.g. a skinny job with a long K streams on
+// into the next job's addresses, and units waiting on the same address lose each other's completions
+static void reserve_stream(const SystolicArray::SysArrayJob *job, int sz, bool ws) {
+  alloc_addr = std::max<uint64_t>(alloc_addr, job->addr_hold + gemm_job_bytes(job->M, job->K, job->N, sz, ws));
+}
+
+// `sz` > 0 reserves the bytes the jobs stream on an array of that size, in WS or OS dataflow
+JobList createSAJobs(int m, int k, int n, int num_jobs, int n_cores = 1, int sz = 0, bool ws = false) {
   JobList jobs;
   
-  // Tensor parallelism: split N dimension across cores
-  int core_n = n / n_cores;
-  
+  // Tensor parallelism: split N dimension across cores, the first n % n_cores take a column more
+
   // Per-core task counters for independent scheduling
   static std::vector<int> core_task_counters(n_cores, 0);
+  core_task_counters.resize(std::max<size_t>(core_task_counters.size(), n_cores));  // later archs may have more cores
   for (int core = 0; core < n_cores; ++core) {
+    int core_n = n / n_cores + (core < n % n_cores);
+    if (core_n == 0) continue;
     for (int job = 0; job < num_jobs; ++job) {
       auto sys_job = new SystolicArray::SysArrayJob(m, k, core_n);
       sys_job->core_id = core;  // Assign to specific core for parallel execution
       sys_job->task_idx = core_task_counters[core]++;  // Sequential task ID per core
+      if (sz > 0) reserve_stream(sys_job, sz, ws);
       jobs.push_back(sys_job);
     }
   }
@@ -54,35 +78,41 @@ JobPair Matmul(const ArchConfig &a_config, const LayerConfig &l_config) {
   } else if (l_config.dimensions.size() == 4) {
     M = l_config.dimensions[1];
     K = l_config.dimensions[2];
-    N = l_config.dimensions[3] * l_config.dimensions[0];
+    N = job_dim((int64_t) l_config.dimensions[3] * l_config.dimensions[0], l_config);
   } else {
     std::cerr << "MM Not expecting " << l_config.dimensions.size() << " dimensions..." << std::endl;
     throw std::exception();
   }
 
+  if (mapper_config.enabled) {
+    return map_gemm(a_config, l_config, M, K, N);
+  }
+
   if (a_config.ws) {
     JobList jl;
     
     // WS: Split N first, then check buffer constraints per core
-    int core_n = N / a_config.n_cores;
     std::cout << "WS N-splitting: " << N << " output channels across " << a_config.n_cores << " cores" << std::endl;
     
     static std::vector<int> core_task_counters(a_config.n_cores, 0);
+    core_task_counters.resize(std::max<size_t>(core_task_counters.size(), a_config.n_cores));
     for (int core = 0; core < a_config.n_cores; ++core) {
-      int required_buff_sz_per_core = (M * core_n + M * std::min(K, a_config.sa_sz_allo)) * batch_size * data_type_width;
+      int core_n = N / a_config.n_cores + (core < N % a_config.n_cores);// the remainder goes to the first cores
+      if (core_n == 0) continue;
+      int64_t required_buff_sz_per_core = ((int64_t) M * core_n + (int64_t) M * std::min(K, a_config.sa_sz_allo)) * batch_size * alloc_act_width;
       bool core_is_bufferable = required_buff_sz_per_core <= buffer_size_bytes;
       
       if (core_is_bufferable) {
         auto job = new SystolicArray::SysArrayJob(M, K, core_n);
         job->core_id = core;
         job->task_idx = core_task_counters[core]++;
+        reserve_stream(job, a_config.sa_sz_allo, true);
         jl.push_back(job);
         std::cout << "  Core " << core << ": " << core_n << " out dim - bufferable" << std::endl;
       } else {
         // Fallback: sequential jobs if buffer too small
         std::cout << "  Core " << core << ": " << core_n << " out dim - not bufferable, using sequential execution" << std::endl;
-        float new_N_f = (float) buffer_size_bytes / float(data_type_width * M * batch_size);
-        int N_per_job = std::max(1, (int) std::floor(new_N_f));
+        int N_per_job = (int) std::max<int64_t>(1, buffer_size_bytes / ((int64_t) alloc_act_width * M * batch_size));
         int num_sequential_jobs = (core_n + N_per_job - 1) / N_per_job;
         
         for (int i = 0; i < num_sequential_jobs; ++i) {
@@ -91,6 +121,7 @@ JobPair Matmul(const ArchConfig &a_config, const LayerConfig &l_config) {
           auto job = new SystolicArray::SysArrayJob(M, K, current_N);
           job->core_id = core;
           job->task_idx = core_task_counters[core]++;
+          reserve_stream(job, a_config.sa_sz_allo, true);
           jl.push_back(job);
         }
       }
@@ -101,7 +132,7 @@ JobPair Matmul(const ArchConfig &a_config, const LayerConfig &l_config) {
     int num_jobs = std::max(1, M / a_config.sa_sz_allo);
     JobList matmul_layers = createSAJobs(a_config.sa_sz_allo,
                                          K,
-                                         N, num_jobs, a_config.n_cores);
+                                         N, num_jobs, a_config.n_cores, a_config.sa_sz_allo);
     return {matmul_layers, matmul_layers};
   }
 }
@@ -136,8 +167,8 @@ JobPair Conv(const ArchConfig &a_config, const LayerConfig &l_config) {
   // M = batch * output_height * output_width (number of output spatial positions)
   // K = input_channels * kernel_size * kernel_size (input channels * kernel area) 
   // N = output_channels (number of filters)
-  M = batch * output_height * output_width;
-  K = input_channels * kernel_size * kernel_size;
+  M = job_dim((int64_t) batch * output_height * output_width, l_config);
+  K = job_dim((int64_t) input_channels * kernel_size * kernel_size, l_config);
   N = output_channels;
   
   std::cout << "Conv2GEMM: batch=" << batch << ", in_ch=" << input_channels << ", in_h=" << input_height << ", in_w=" << input_width << std::endl;
@@ -145,30 +176,36 @@ JobPair Conv(const ArchConfig &a_config, const LayerConfig &l_config) {
   std::cout << "           out_h=" << output_height << ", out_w=" << output_width << std::endl;
   std::cout << "           GEMM dimensions: M=" << M << ", K=" << K << ", N=" << N << std::endl;
 
+  if (mapper_config.enabled) {
+    return map_gemm(a_config, l_config, M, K, N);
+  }
+
   if (a_config.ws) {
     JobList jl;
     
-  // First split N by number of cores (assume remainder is 0)
-    int core_n = N / a_config.n_cores;
+    // First split N by number of cores
     std::cout << "Conv WS N-splitting: " << N << " output channels across " << a_config.n_cores << " cores" << std::endl;
     
     static std::vector<int> core_task_counters(a_config.n_cores, 0);  // Per-core task counters
+    core_task_counters.resize(std::max<size_t>(core_task_counters.size(), a_config.n_cores));
     for (int core = 0; core < a_config.n_cores; ++core) {
+      int core_n = N / a_config.n_cores + (core < N % a_config.n_cores);// the remainder goes to the first cores
+      if (core_n == 0) continue;
       // Check if this core's portion fits in buffer
-      int required_buff_sz_per_core = (M * core_n + M * std::min(K, a_config.sa_sz_allo)) * batch_size * data_type_width;
+      int64_t required_buff_sz_per_core = ((int64_t) M * core_n + (int64_t) M * std::min(K, a_config.sa_sz_allo)) * batch_size * alloc_act_width;
       bool core_is_bufferable = required_buff_sz_per_core <= buffer_size_bytes;
       
       if (core_is_bufferable) {
         auto job = new SystolicArray::SysArrayJob(M, K, core_n);
         job->core_id = core;  // Assign core ID for parallel scheduling
         job->task_idx = core_task_counters[core]++;  // Sequential task ID per core (0,1,2,3...)
+        reserve_stream(job, a_config.sa_sz_allo, true);
         jl.push_back(job);
         std::cout << "  Core " << core << ": " << core_n << " out dim - bufferable (core_id=" << core << ")" << std::endl;
       } else {
         // Sequential execution for this core's portion
         std::cout << "  Core " << core << ": " << core_n << " out dim - not bufferable, using sequential execution" << std::endl;
-        float new_N_f = (float) buffer_size_bytes / float(data_type_width * M * batch_size);
-        int N_per_job = std::max(1, (int) std::floor(new_N_f));
+        int N_per_job = (int) std::max<int64_t>(1, buffer_size_bytes / ((int64_t) alloc_act_width * M * batch_size));
         int num_sequential_jobs = (core_n + N_per_job - 1) / N_per_job;
         
         for (int i = 0; i < num_sequential_jobs; ++i) {
@@ -177,6 +214,7 @@ JobPair Conv(const ArchConfig &a_config, const LayerConfig &l_config) {
           auto job = new SystolicArray::SysArrayJob(M, K, current_N);
           job->core_id = core;
           job->task_idx = core_task_counters[core]++;
+          reserve_stream(job, a_config.sa_sz_allo, true);
           jl.push_back(job);
         }
       }
@@ -187,7 +225,7 @@ JobPair Conv(const ArchConfig &a_config, const LayerConfig &l_config) {
     int num_jobs = std::max(1, M / a_config.sa_sz_allo);
     JobList matmul_layers = createSAJobs(a_config.sa_sz_allo,
                                          K,
-                                         N, num_jobs, a_config.n_cores);
+                                         N, num_jobs, a_config.n_cores, a_config.sa_sz_allo);
     return {matmul_layers, matmul_layers};
   }
 }
@@ -203,7 +241,7 @@ JobPair MatmulAct(const ArchConfig &a_config, const LayerConfig &l_config) {
   } else if (l_config.dimensions.size() == 4) {
     M = l_config.dimensions[1];
     K = l_config.dimensions[2];
-    N = l_config.dimensions[3] * l_config.dimensions[0];
+    N = job_dim((int64_t) l_config.dimensions[3] * l_config.dimensions[0], l_config);
   } else {
     std::cerr << "MA Not expecting " << l_config.dimensions.size() << " dimensions..." << std::endl;
     throw std::exception();
@@ -214,8 +252,8 @@ JobPair MatmulAct(const ArchConfig &a_config, const LayerConfig &l_config) {
 
     JobList matmul_layers = createSAJobs(M,
                                          a_config.sa_sz_allo,
-                                         N, num_jobs);
-    JobList act_layer = {new VectorUnit::VecUnitJob(1, M * K, true, {{VectorUnit::VPUPhase::BROADCAST, 1}})};
+                                         N, num_jobs, 1, a_config.sa_sz_allo, true);
+    JobList act_layer = {new VectorUnit::VecUnitJob(1, job_dim((int64_t) M * K, l_config), true, {{VectorUnit::VPUPhase::BROADCAST, 1}})};
 
     connectJobLists(matmul_layers, act_layer);
 
@@ -224,8 +262,8 @@ JobPair MatmulAct(const ArchConfig &a_config, const LayerConfig &l_config) {
     int num_jobs = std::max(1, M / a_config.sa_sz_allo);
     JobList matmul_layers = createSAJobs(a_config.sa_sz_allo,
                                          K,
-                                         N, num_jobs);
-    JobList act_layer = {new VectorUnit::VecUnitJob(1, M * K, true, {{VectorUnit::VPUPhase::BROADCAST, 1}})};
+                                         N, num_jobs, 1, a_config.sa_sz_allo);
+    JobList act_layer = {new VectorUnit::VecUnitJob(1, job_dim((int64_t) M * K, l_config), true, {{VectorUnit::VPUPhase::BROADCAST, 1}})};
 
     connectJobLists(matmul_layers, act_layer);
 
@@ -243,20 +281,20 @@ JobPair ActMatmul(const ArchConfig &a_config, const LayerConfig &l_config) {
   } else if (l_config.dimensions.size() == 4) {
     M = l_config.dimensions[1];
     K = l_config.dimensions[2];
-    N = l_config.dimensions[3] * l_config.dimensions[0];
+    N = job_dim((int64_t) l_config.dimensions[3] * l_config.dimensions[0], l_config);
   } else {
     std::cerr << "AM Not expecting " << l_config.dimensions.size() << " dimensions..." << std::endl;
     throw std::exception();
   }
 
   // Create activation layer job
-  JobList act_layer = {new VectorUnit::VecUnitJob(1, M * K, true, {{VectorUnit::VPUPhase::BROADCAST, 1}})};
+  JobList act_layer = {new VectorUnit::VecUnitJob(1, job_dim((int64_t) M * K, l_config), true, {{VectorUnit::VPUPhase::BROADCAST, 1}})};
 
   if (a_config.ws) {
     int num_jobs = std::max(1, K / a_config.sa_sz_allo);
     JobList matmul_layers = createSAJobs(M,
                                          a_config.sa_sz_allo,
-                                         N, num_jobs);
+                                         N, num_jobs, 1, a_config.sa_sz_allo, true);
     connectJobLists(act_layer, matmul_layers);
 
     return {act_layer, matmul_layers};
@@ -264,7 +302,7 @@ JobPair ActMatmul(const ArchConfig &a_config, const LayerConfig &l_config) {
     int num_jobs = std::max(1, M / a_config.sa_sz_allo);
     JobList matmul_layers = createSAJobs(a_config.sa_sz_allo,
                                          K,
-                                         N, num_jobs);
+                                         N, num_jobs, 1, a_config.sa_sz_allo);
     connectJobLists(act_layer, matmul_layers);
 
     return {act_layer, matmul_layers};
@@ -283,7 +321,7 @@ JobPair LayerNorm(const ArchConfig &a_config, const LayerConfig &l_config) {
       lin_dim = l_config.dimensions[1];
       break;
     case 3:
-      par_dim = l_config.dimensions[0] * l_config.dimensions[1];
+      par_dim = job_dim((int64_t) l_config.dimensions[0] * l_config.dimensions[1], l_config);
       lin_dim = l_config.dimensions[2] / l_config.dimensions[0];
       if (l_config.dimensions[2] % l_config.dimensions[0] != 0) {
         std::cerr << "linear dimension is not divisible by group size in layernorm..." << std::endl;
@@ -297,7 +335,7 @@ JobPair LayerNorm(const ArchConfig &a_config, const LayerConfig &l_config) {
   // Create jobs with buffer size constraints
   JobList jl;
   int par_acc = par_dim;
-  int dec_amt = buffer_size_bytes / data_type_width / lin_dim;
+  int dec_amt = std::max(1, buffer_size_bytes / alloc_act_width / lin_dim);
   while (par_acc > 0) {
     jl.push_back(new VectorUnit::VecUnitJob(lin_dim, std::min(dec_amt, par_acc), false,
                                             {{VectorUnit::VPUPhase::REDUCE, 1}, {VectorUnit::VPUPhase::REDUCE, 4}, {VectorUnit::VPUPhase::BROADCAST, 1}}));
@@ -307,30 +345,72 @@ JobPair LayerNorm(const ArchConfig &a_config, const LayerConfig &l_config) {
 }
 
 JobPair Activation(const ArchConfig &a_config, const LayerConfig &l_config) {
-  int sz = 1;
-  for (const auto &dim: l_config.dimensions) sz *= dim;
+  int64_t sz = 1;
+  for (const auto &dim: l_config.dimensions) sz = job_dim(sz * dim, l_config);
+
+  auto job = new VectorUnit::VecUnitJob(1, sz, false, {{VectorUnit::VPUPhase::BROADCAST, 1}});
+  return {{job}, {job}};
+}
 
+JobPair Add(const ArchConfig &a_config, const LayerConfig &l_config) {
+  int64_t sz = 1;
+  for (const auto &dim: l_config.dimensions) sz = job_dim(sz * dim, l_config);
+
+  // Element-wise sum of every input tensor, e.g. a residual connection
   auto job = new VectorUnit::VecUnitJob(1, sz, false, {{VectorUnit::VPUPhase::BROADCAST, 1}});
+  job->n_operands = std::max(2, (int) l_config.inputs.size());
+  // The job streams every operand in and the sum out from its address, more than one tensor's worth
+  alloc_addr = std::max<uint64_t>(alloc_addr, job->addr_hold + (uint64_t) (job->n_operands + 1) * sz * alloc_act_width * batch_size);
+  return {{job}, {job}};
+}
+
+JobPair KVCacheWrite(const ArchConfig &a_config, const LayerConfig &l_config) {
+  // Append K and V of `tokens` new tokens: tokens x hidden
+  if (l_config.dimensions.size() != 2) {
+    std::cerr << "KVW Not expecting " << l_config.dimensions.size() << " dimensions..." << std::endl;
+    throw std::exception();
+  }
+  auto job = new VectorUnit::VecUnitJob(1, job_dim(2 * (int64_t) l_config.dimensions[0] * l_config.dimensions[1], l_config), true,
+                                        {{VectorUnit::VPUPhase::BROADCAST, 1}});
+  return {{job}, {job}};
+}
+
+JobPair KVCacheRead(const ArchConfig &a_config, const LayerConfig &l_config) {
+  // Stream K and V of `tokens` cached tokens back in: tokens x hidden, nothing is written
+  if (l_config.dimensions.size() != 2) {
+    std::cerr << "KVR Not expecting " << l_config.dimensions.size() << " dimensions..." << std::endl;
+    throw std::exception();
+  }
+  auto job = new VectorUnit::VecUnitJob(1, job_dim(2 * (int64_t) l_config.dimensions[0] * l_config.dimensions[1], l_config), false,
+                                        {{VectorUnit::VPUPhase::BROADCAST, 1}});
+  job->writes_output = false;
   return {{job}, {job}};
 }
 
 JobPair Softmax(const ArchConfig &a_config, const LayerConfig &l_config) {
-  int M;
+  // Row-wise softmax over heads x rows x cols, square per head unless cols is given
+  int rows, cols;
   int heads = 1;
   if (l_config.dimensions.size() == 1) {
-    M = l_config.dimensions[0];
+    rows = cols = l_config.dimensions[0];
   } else if (l_config.dimensions.size() == 2) {
     heads = l_config.dimensions[0];
-    M = l_config.dimensions[1];
+    rows = cols = l_config.dimensions[1];
+  } else if (l_config.dimensions.size() == 3) {
+    heads = l_config.dimensions[0];
+    rows = l_config.dimensions[1];
+    cols = l_config.dimensions[2];
   } else {
     std::cerr << "SM Not expecting " << l_config.dimensions.size() << " dimensions..." << std::endl;
     throw std::exception();
   }
 
-  int spl = 1;
-  int Mp = M * heads;
-  if (heads * M * M * data_type_width * batch_size > buffer_size_bytes || Mp > 1024) {
-    spl = std::max(div_ru(heads * M * M * data_type_width * batch_size, buffer_size_bytes), div_ru(Mp, 1024));
+  // Rows per job come from the buffer and a fixed cap of 1024, -map only searches GEMM splits
+  int64_t spl = 1;
+  int Mp = job_dim((int64_t) rows * heads, l_config);
+  int64_t bytes = (int64_t) heads * rows * cols * alloc_act_width * batch_size;
+  if (bytes > buffer_size_bytes || Mp > 1024) {
+    spl = std::max(div_ru(bytes, buffer_size_bytes), div_ru(Mp, 1024));
     if (spl > Mp) {
       std::cerr << "Can't split this enough to fit inside buffer." << std::endl;
       throw std::exception();
@@ -339,10 +419,10 @@ JobPair Softmax(const ArchConfig &a_config, const LayerConfig &l_config) {
   }
   std::cout << "Splitting by " << spl << std::endl;
 
-  int n_jobs = div_ru(div_ru(M * heads, Mp), n_vpus);
+  int64_t n_jobs = div_ru(div_ru((int64_t) rows * heads, Mp), n_vpus);
   JobList softmax_layer;
   for (int i = 0; i < n_jobs; ++i)
-    softmax_layer.push_back(new VectorUnit::VecUnitJob(M, Mp, false, softmax_phases));
+    softmax_layer.push_back(new VectorUnit::VecUnitJob(cols, Mp, false, softmax_phases));
 
   return {softmax_layer, softmax_layer};
 }
@@ -377,46 +457,52 @@ JobPair SelfAttention(const ArchConfig &a_config, const LayerConfig &l_config) {
     auto O_proj = Matmul(a_config, LayerConfig("Matmul", {n_heads, M, N / n_heads, K}));
     auto softmax_layer = Softmax(a_config, LayerConfig("Softmax", {8, M}));
 
-    // Chain operations: K->Q->V->QK^T->softmax->attention*V->output
-    connectJobs(K_proj, Q_proj);
-    connectJobs(Q_proj, V_proj);
-    connectJobs(V_proj, Dot1);
+    // K, Q and V projections are independent: QK^T waits on K and Q, attention*V on softmax and V
+    connectJobs(K_proj, Dot1);
+    connectJobs(Q_proj, Dot1);
     connectJobs(Dot1, softmax_layer);
     connectJobs(softmax_layer, Dot2);
+    connectJobs(V_proj, Dot2);
     connectJobs(Dot2, O_proj);
-    return {K_proj.first, O_proj.second};
+
+    JobList heads = K_proj.first;
+    heads.insert(heads.end(), Q_proj.first.begin(), Q_proj.first.end());
+    heads.insert(heads.end(), V_proj.first.begin(), V_proj.first.end());
+    return {heads, O_proj.second};
   } else {
     int num_jobs = std::max(1, M / a_config.sa_sz_allo);
     JobList K_proj = createSAJobs(a_config.sa_sz_allo,
                                   K,
-                                  N, num_jobs);
+                                  N, num_jobs, 1, a_config.sa_sz_allo);
     JobList Q_proj = createSAJobs(a_config.sa_sz_allo,
                                   K,
-                                  N, num_jobs);
+                                  N, num_jobs, 1, a_config.sa_sz_allo);
     JobList V_proj = createSAJobs(a_config.sa_sz_allo,
                                   K,
-                                  N, num_jobs);
+                                  N, num_jobs, 1, a_config.sa_sz_allo);
     JobList Dot1 = createSAJobs(a_config.sa_sz_allo,
                                 K,// / m_config.n_heads,
-                                M, num_jobs);
+                                M, num_jobs, 1, a_config.sa_sz_allo);
     JobList Dot2 = createSAJobs(a_config.sa_sz_allo,
                                 M,
-                                N, num_jobs);/// m_config.n_heads
+                                N, num_jobs, 1, a_config.sa_sz_allo);/// m_config.n_heads
     JobList O_proj = createSAJobs(a_config.sa_sz_allo,
                                   K,
-                                  N, num_jobs);
+                                  N, num_jobs, 1, a_config.sa_sz_allo);
 
     JobList softmax_layer = {new VectorUnit::VecUnitJob(M, M, true,
                                                         {{VectorUnit::VPUPhase::REDUCE, 1}, {VectorUnit::VPUPhase::REDUCE, 1}, {VectorUnit::VPUPhase::BROADCAST, 1}})};
-    connectJobLists(K_proj, Q_proj);
+    connectJobLists(K_proj, Dot1);
     connectJobLists(Q_proj, Dot1);
     connectJobLists(Dot1, softmax_layer);
-    connectJobLists(softmax_layer, V_proj);
+    connectJobLists(softmax_layer, Dot2);
     connectJobLists(V_proj, Dot2);
     connectJobLists(Dot2, O_proj);
 
-
-    return {K_proj, O_proj};
+    JobList heads = K_proj;
+    heads.insert(heads.end(), Q_proj.begin(), Q_proj.end());
+    heads.insert(heads.end(), V_proj.begin(), V_proj.end());
+    return {heads, O_proj};
   }
 }
 
@@ -435,6 +521,62 @@ JobPair MultiHeadSelfAttention(const ArchConfig &a_config, const LayerConfig &l_
 }
 
 
+JobCreate_f getLayerLambda(const std::string &layer_type);
+
+JobPair LLMInference(const ArchConfig &a_config, const LayerConfig &l_config) {
+  // n_layers, hidden, heads, prompt_len, gen_tokens[, ffn_dim]
+  if (l_config.dimensions.size() != 5 && l_config.dimensions.size() != 6) {
+    std::cerr << "LLM Not expecting " << l_config.dimensions.size() << " dimensions..." << std::endl;
+    throw std::exception();
+  }
+  const auto &d = l_config.dimensions;
+  LLMRun run;
+  run.cfg = {d[0], d[1], d[2], d[3], d[4], d.size() > 5 ? d[5] : 4 * d[1]};
+  if (run.cfg.hidden % run.cfg.heads != 0) {
+    throw std::runtime_error("LLMInference: hidden size must be divisible by the number of heads");
+  }
+  if (run.cfg.prompt_len < 1 || run.cfg.gen_tokens < 1) {
+    throw std::runtime_error("LLMInference: needs at least one prompt and one generated token");
+  }
+
+  // The prefill produces the first token, every later token needs one decode pass. Each layer of
+  // each pass gets its own record, named after the LLMInference line.
+  const int parent_idx = alloc_layer_idx;
+  const std::string parent = parent_idx >= 0 ? layer_names[parent_idx] : "LLMInference";
+  JobList prev_sinks;
+  for (int pass = 0; pass < run.cfg.gen_tokens; ++pass) {
+    int tokens = pass == 0 ? run.cfg.prompt_len : 1;
+    int past = pass == 0 ? 0 : run.cfg.prompt_len + pass - 1;
+    auto configs = llm_pass_layers(run.cfg, tokens, past);
+    if (fusion_config.enabled) configs = fuse_layers(configs, a_config.n_cores, false);
+
+    std::vector<JobPair> lists;
+    std::string pass_name = parent + (pass == 0 ? "/prefill/" : "/decode" + std::to_string(pass) + "/");
+    for (int l = 0; l < (int) configs.size(); ++l) {
+      const auto &c = configs[l];
+      alloc_layer_idx = layer_index(pass_name + std::to_string(l) + ":" + c.layer_type + ":" + c.outputs[0]);
+      lists.push_back(getLayerLambda(c.layer_type)(a_config, c));
+      apply_fusion(c, lists.back());
+    }
+    std::vector<int> roots, sinks;
+    connectLayerGraph(configs, lists, roots, sinks);
+
+    JobList pass_roots, pass_sinks;
+    for (int i: roots) pass_roots.insert(pass_roots.end(), lists[i].first.begin(), lists[i].first.end());
+    for (int i: sinks) pass_sinks.insert(pass_sinks.end(), lists[i].second.begin(), lists[i].second.end());
+    if (pass == 0) {
+      run.prefill_roots = pass_roots;
+    } else {
+      connectJobLists(prev_sinks, pass_roots);
+    }
+    run.pass_sinks.push_back(pass_sinks);
+    prev_sinks = pass_sinks;
+  }
+  alloc_layer_idx = parent_idx;
+  llm_runs.push_back(run);
+  return {run.prefill_roots, prev_sinks};
+}
+
 JobCreate_f getLayerLambda(const std::string &layer_type) {
   if (layer_type == "Matmul")
     return Matmul;
@@ -446,6 +588,14 @@ JobCreate_f getLayerLambda(const std::string &layer_type) {
     return Softmax;
   if (layer_type == "Activation")
     return Activation;
+  if (layer_type == "Add")
+    return Add;
+  if (layer_type == "KVCacheWrite")
+    return KVCacheWrite;
+  if (layer_type == "KVCacheRead")
+    return KVCacheRead;
+  if (layer_type == "LLMInference")
+    return LLMInference;
   if (layer_type == "LayerNorm")
     return LayerNorm;
   if (layer_type == "SelfAttention")
@@ -460,24 +610,38 @@ ArchConfig frontend::standard::arch_config;
 std::vector<JobPair> StandardLayer::make_layers(const std::vector<LayerConfig> &layer_configs) const {
   std::vector<JobPair> model_heads;
   JobList jp;
+  fusion_stats = FusionStats();
   for (int m = 0; m < model_parallelism; ++m) {
+    // Fusion only marks layers, the graph keeps its shape
+    auto configs = fusion_config.enabled ? fuse_layers(layer_configs, arch_config.n_cores, m == 0) : layer_configs;
     std::vector<JobPair> lists;
-    for (const auto &layer_config: layer_configs) {
-      auto layer_f = getLayerLambda(layer_config.layer_type);
-      lists.push_back(layer_f(arch_config, layer_config));
+    for (int l = 0; l < (int) configs.size(); ++l) {
+      auto layer_f = getLayerLambda(configs[l].layer_type);
+      alloc_layer_idx = layer_index(configs[l], l);
+      alloc_act_width = configs[l].act_width > 0 ? configs[l].act_width : data_type_width;
+      alloc_weight_width = configs[l].weight_width > 0 ? configs[l].weight_width : alloc_act_width;
+      lists.push_back(layer_f(arch_config, configs[l]));
+      apply_fusion(configs[l], lists.back());
     }
+    alloc_layer_idx = -1;
+    alloc_act_width = alloc_weight_width = data_type_width;
     std::cout << "list size: " << lists.size() << std::endl;
-    for (int i = 1; i < lists.size(); ++i) {
-      connectJobLists(lists[i - 1].second, lists[i].first);
-      std::cout << "connect " << i << " to " << (i - 1) << std::endl;
-    }
+    std::vector<int> roots, sinks;
+    connectLayerGraph(configs, lists, roots, sinks);
+    std::cout << "graph roots: " << roots.size() << ", sinks: " << sinks.size() << std::endl;
+
+    JobList sink_jobs;
+    for (int i: sinks) sink_jobs.insert(sink_jobs.end(), lists[i].second.begin(), lists[i].second.end());
     if (m == 0 || do_par) {
-      model_heads.push_back(lists[0]);
-      jp = lists.back().second;
+      for (int i: roots) model_heads.push_back(lists[i]);
     } else {
-      connectJobLists(jp, lists[0].first);
-      jp = lists[0].second;
+      for (int i: roots) connectJobLists(jp, lists[i].first);
     }
+    jp = sink_jobs;
+  }
+  if (fusion_config.enabled) {
+    std::cout << "Fusion: " << fusion_stats.fused << " intermediate tensors kept on chip, " << fusion_stats.write_bytes
+              << " bytes of DRAM writes and " << fusion_stats.read_bytes << " bytes of reads saved" << std::endl;
   }
 
   return model_heads;
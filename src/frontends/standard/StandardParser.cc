@@ -8,22 +8,36 @@
  */
 
 #include "frontends/standard/StandardParser.h"
+#include "frontends/standard/Fusion.h"
+#include "frontends/standard/Mapper.h"
 
 using namespace frontend::standard;
 
 Arch* StandardParser::make_arch() {
-  int cores;
-  int sa_sz;
-  int vu_sz;
-  int ws;
+  int cores = 1;
+  int sa_sz = 64;
+  int vu_sz = 64;
+  int ws = 0;// output stationary unless -ws is given
+  int map = 0;
+  int map_verify = 0;
+  int fuse = 0;
   parse_args({{"-c", &cores},
               {"-sa_sz", &sa_sz},
               {"-vu_sz", &vu_sz},
-              {"-ws", &ws}},
+              {"-ws", &ws},
+              {"-map", &map},
+              {"-map_verify", &map_verify},
+              {"-fuse", &fuse}},
              "-c       number of cores\n"
              "-sa_sz   size of the systolic array\n"
              "-sz_vu   size of the vector unit\n"
-             "-ws      weight stationary (1) or output stationary (0)");
+             "-ws      weight stationary (1) or output stationary (0)\n"
+             "-map     split Matmul and Conv layers by a mapping search (1) or the fixed heuristics (0)\n"
+             "-map_verify  simulate the mapper's best <int> candidates per layer and keep the fastest\n"
+             "-fuse    keep intermediates of fusable layer pairs on chip (1) or write them to DRAM (0)");
   arch_config = ArchConfig(cores, sa_sz, vu_sz, ws);
+  mapper_config.enabled = map != 0 || map_verify > 0;
+  mapper_config.verify_top = map_verify;
+  fusion_config.enabled = fuse != 0;
   return new StandardArch;
 }
@@ -0,0 +1,224 @@
+/*
+ * COCOSSim: A Cycle-Accurate Neural Network Accelerator Simulator
+ * 
+ * Copyright (c) 2025 APEX Lab, Duke University
+ * 
+ * This software is distributed under the terms of the Apache License 2.0.
+ * See LICENSE file for details.
+ */
+
+#include "frontends/torch/TorchLayer.h"
+#include "Json.h"
+
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace frontend::torch;
+
+FxConfig frontend::torch::fx_config;
+
+namespace {
+  // Ops are matched by their function name or lowercased module type, in-place variants (gelu_) included
+  const std::set<std::string> activation_ops = {"relu", "relu6", "gelu", "silu", "sigmoid", "tanh", "hardswish",
+                                                "hardsigmoid", "leaky_relu", "leakyrelu", "elu", "selu", "celu",
+                                                "prelu", "mish", "softplus", "softsign", "hardtanh", "logsigmoid",
+                                                "quick_gelu", "batch_norm", "batchnorm1d", "batchnorm2d",
+                                                "batchnorm3d", "neg", "exp", "log", "sqrt", "rsqrt", "pow",
+                                                "square", "reciprocal", "abs", "clamp", "clip", "erf", "sin", "cos",
+                                                "scale"};
+  const std::set<std::string> norm_ops = {"layer_norm", "layernorm", "native_layer_norm", "rms_norm", "rmsnorm",
+                                          "group_norm", "groupnorm", "instance_norm", "instancenorm1d",
+                                          "instancenorm2d", "instancenorm3d"};
+  // Several tensors in, one Add that streams them all; with a single tensor (e.g. x / 2) an Activation
+  const std::set<std::string> elementwise_ops = {"add", "mul", "sub", "div", "iadd", "imul", "isub", "idiv"};
+  const std::set<std::string> alias_ops = {"view", "reshape", "permute", "transpose", "flatten", "contiguous",
+                                           "getitem", "dropout", "identity", "unsqueeze", "squeeze", "expand",
+                                           "size", "to", "type_as", "chunk", "split", "output"};
+
+  int to_dim(int64_t d, const std::string &node) {
+    if (d <= 0 || d > INT32_MAX) {
+      throw std::runtime_error("fx graph: node '" + node + "' has unsupported dimension " + std::to_string(d));
+    }
+    return (int) d;
+  }
+
+  int64_t prod(const std::vector<int64_t> &v, size_t from, size_t to) {
+    int64_t p = 1;
+    for (size_t i = from; i < to && i < v.size(); ++i) p *= v[i];
+    return p;
+  }
+
+  std::vector<int> shape_dims(const std::vector<int64_t> &shape, const std::string &node) {
+    std::vector<int> dims;
+    for (auto d: shape) dims.push_back(to_dim(d, node));
+    if (dims.empty()) dims.push_back(1);
+    return dims;
+  }
+}// namespace
+
+std::vector<LayerConfig> TorchLayer::read_layers(const std::string &fname) const {
+  json::Value root = json::parse_file(fname);
+  const json::Value &nodes = root.at("nodes");
+  if (!nodes.is_array()) throw std::runtime_error("fx graph: 'nodes' must be an array");
+
+  // Shape-only nodes forward the tensor they read, so consumers are wired to the real producer
+  std::unordered_map<std::string, std::string> alias;
+  auto resolve = [&](const std::string &name) {
+    auto it = alias.find(name);
+    return it == alias.end() ? name : it->second;
+  };
+
+  std::set<std::string> graph_inputs;// placeholders, weights and the stand-in inputs of input-less nodes
+  std::vector<LayerConfig> layers;
+  for (const auto &node: nodes.arr) {
+    const std::string name = node.at("name").as_string();
+    std::string op = node.at("op").as_string();
+    if (op.size() > 1 && op.back() == '_' && op[op.size() - 2] != '_') op.pop_back();
+
+    std::vector<std::string> inputs;
+    if (auto *in = node.get("inputs")) {
+      for (const auto &i: in->arr) inputs.push_back(resolve(i.as_string()));
+    }
+    std::vector<std::vector<int64_t>> in_shapes;
+    if (auto *sh = node.get("input_shapes")) {
+      for (const auto &s: sh->arr) {
+        if (!s.is_null()) in_shapes.push_back(s.as_int_vector());
+      }
+    }
+    std::vector<int64_t> out_shape;
+    if (auto *sh = node.get("output_shape"); sh != nullptr && !sh->is_null()) out_shape = sh->as_int_vector();
+    static const json::Value no_attrs;
+    const json::Value *attrs = node.get("attrs");
+    if (attrs == nullptr) attrs = &no_attrs;
+
+    if (op == "placeholder" || op == "get_attr") {// graph inputs and weights
+      graph_inputs.insert(name);
+      continue;
+    }
+    if (alias_ops.count(op)) {
+      if (!inputs.empty()) alias[name] = inputs.front();
+      continue;
+    }
+
+    LayerConfig l_config;
+    if (op == "linear" || op == "addmm") {
+      // [*, K] x [K, N] -> [*, N]
+      if (in_shapes.empty() || out_shape.empty()) throw std::runtime_error("fx graph: '" + name + "' is missing shapes");
+      const auto &x = in_shapes.front();
+      l_config.layer_type = "Matmul";
+      l_config.dimensions = {to_dim(prod(x, 0, x.size() - 1), name), to_dim(x.back(), name), to_dim(out_shape.back(), name)};
+    } else if (op == "matmul" || op == "bmm") {
+      // [..., M, K] x [..., K, N] -> [..., M, N], leading dims become heads
+      if (in_shapes.size() < 2) throw std::runtime_error("fx graph: '" + name + "' needs two input shapes");
+      const auto &a = in_shapes[0];
+      const auto &b = in_shapes[1];
+      if (a.size() < 2 || b.size() < 2) throw std::runtime_error("fx graph: '" + name + "' needs rank >= 2 operands");
+      int64_t batch = prod(a, 0, a.size() - 2);
+      int M = to_dim(a[a.size() - 2], name), K = to_dim(a.back(), name), N = to_dim(b.back(), name);
+      l_config.layer_type = "Matmul";
+      if (batch == 1) {
+        l_config.dimensions = {M, K, N};
+      } else {
+        l_config.dimensions = {to_dim(batch, name), M, K, N};
+      }
+    } else if (op == "sdpa") {
+      // softmax(Q Kᵀ) V as Matmul -> Softmax -> Matmul, leading dims become heads. A mask input
+      // is not modelled.
+      if (in_shapes.size() < 3 || inputs.size() < 3) throw std::runtime_error("fx graph: sdpa '" + name + "' needs query, key and value shapes");
+      const auto &q = in_shapes[0], &k = in_shapes[1], &v = in_shapes[2];
+      if (q.size() < 2 || k.size() < 2 || v.size() < 2) throw std::runtime_error("fx graph: sdpa '" + name + "' needs rank >= 2 operands");
+      int heads = to_dim(prod(q, 0, q.size() - 2), name);
+      int L = to_dim(q[q.size() - 2], name), E = to_dim(q.back(), name);
+      int S = to_dim(k[k.size() - 2], name), Ev = to_dim(v.back(), name);
+      auto gemm_dims = [&](int M, int K, int N) { return heads == 1 ? std::vector<int>{M, K, N} : std::vector<int>{heads, M, K, N}; };
+
+      LayerConfig scores;
+      scores.layer_type = "Matmul";
+      scores.dimensions = gemm_dims(L, E, S);
+      scores.inputs = {inputs[0], inputs[1]};
+      scores.outputs = {name + ".scores"};
+      LayerConfig probs;
+      probs.layer_type = "Softmax";
+      probs.dimensions = {heads, L, S};
+      probs.inputs = scores.outputs;
+      probs.outputs = {name + ".probs"};
+      for (const auto *l: {&scores, &probs}) {
+        std::cout << "fx node " << name << " (" << op << ") -> " << l->layer_type;
+        for (int d: l->dimensions) std::cout << " " << d;
+        std::cout << std::endl;
+        layers.push_back(*l);
+      }
+
+      l_config.layer_type = "Matmul";
+      l_config.dimensions = gemm_dims(L, S, Ev);
+      inputs = {probs.outputs[0], inputs[2]};
+    } else if (op == "conv2d") {
+      // batch, input_channels, input_height, input_width, output_channels, kernel_size, stride, padding
+      if (in_shapes.empty() || in_shapes.front().size() != 4) throw std::runtime_error("fx graph: conv2d '" + name + "' needs an NCHW input shape");
+      const auto &x = in_shapes.front();
+      int64_t out_channels = attrs->get_int("out_channels", out_shape.size() == 4 ? out_shape[1] : 0);
+      auto first = [&](const char *key, int64_t dflt) {
+        auto *v = attrs->get(key);
+        if (v == nullptr || v->is_string()) return dflt;
+        auto vec = v->as_int_vector();
+        return vec.empty() ? dflt : vec.front();
+      };
+      int kernel = to_dim(first("kernel_size", 3), name);
+      int padding = (int) first("padding", 0);
+      if (auto *v = attrs->get("padding"); v != nullptr && v->is_string()) {
+        // padding="same" keeps the size at stride 1, an even kernel loses the extra row torch pads on one side
+        if (v->as_string() == "same") {
+          padding = (kernel - 1) / 2;
+        } else if (v->as_string() != "valid") {
+          throw std::runtime_error("fx graph: conv2d '" + name + "' has unsupported padding '" + v->as_string() + "'");
+        }
+      }
+      l_config.layer_type = "Conv";
+      l_config.dimensions = {to_dim(x[0], name), to_dim(x[1], name), to_dim(x[2], name), to_dim(x[3], name),
+                             to_dim(out_channels, name), kernel, to_dim(first("stride", 1), name), padding};
+    } else if (op == "softmax" || op == "log_softmax") {
+      // Rows of the last dimension: heads x rows x cols
+      if (out_shape.empty()) throw std::runtime_error("fx graph: '" + name + "' is missing its output shape");
+      int cols = to_dim(out_shape.back(), name);
+      int64_t rows = prod(out_shape, 0, out_shape.size() - 1);
+      int64_t heads = out_shape.size() > 2 ? prod(out_shape, 0, out_shape.size() - 2) : 1;
+      l_config.layer_type = "Softmax";
+      l_config.dimensions = {to_dim(heads, name), to_dim(rows / heads, name), cols};
+    } else if (norm_ops.count(op)) {
+      if (out_shape.empty()) throw std::runtime_error("fx graph: '" + name + "' is missing its output shape");
+      l_config.layer_type = "LayerNorm";
+      l_config.dimensions = {to_dim(prod(out_shape, 0, out_shape.size() - 1), name), to_dim(out_shape.back(), name)};
+    } else if (elementwise_ops.count(op) && inputs.size() >= 2) {
+      l_config.layer_type = "Add";
+      l_config.dimensions = shape_dims(out_shape, name);
+    } else if (activation_ops.count(op) || elementwise_ops.count(op)) {
+      l_config.layer_type = "Activation";
+      l_config.dimensions = shape_dims(out_shape, name);
+    } else if (inputs.size() == 1 && fx_config.unknown_as_view) {
+      std::cerr << "Warning: fx graph: unsupported op '" << op << "' at node '" << name << "', treating it as a view" << std::endl;
+      alias[name] = inputs.front();
+      continue;
+    } else {
+      throw std::runtime_error("fx graph: unsupported op '" + op + "' at node '" + name + "'" +
+                               (inputs.size() == 1 ? ", -fx_unknown_as_view skips it as a free view" : ""));
+    }
+
+    // Always name an input so the layer is never chained onto the previous node by position
+    if (inputs.empty()) graph_inputs.insert(name + ".in");
+    l_config.inputs = inputs.empty() ? std::vector<std::string>{name + ".in"} : inputs;
+    l_config.outputs = {name};
+    std::cout << "fx node " << name << " (" << op << ") -> " << l_config.layer_type;
+    for (int d: l_config.dimensions) std::cout << " " << d;
+    std::cout << std::endl;
+    layers.push_back(l_config);
+  }
+  if (layers.empty()) throw std::runtime_error("fx graph: no supported compute nodes in " + fname);
+  for (auto &l: layers) {
+    for (const auto &t: l.inputs) {
+      if (graph_inputs.count(t)) l.graph_inputs.push_back(t);
+    }
+  }
+  return layers;
+}
@@ -8,36 +8,51 @@
  */
 
 #include "global.h"
-#include <cmath>
+#include <stdexcept>
+#include <string>
 
 int total_jobs = 0;
 int jobs_finished = 0;
 int bytes_per_tx;
 std::vector<std::tuple<uint64_t, bool, int, State *>> to_enqueue;
-FILE *vcd = nullptr;
 uint64_t gcycles = 0;
 int alloc_task_idx = 0;
+int alloc_layer_idx = -1;
+int alloc_act_width = 2;
+int alloc_weight_width = 2;
 int model_parallelism = 1;
 float freq_sa = 1;
 float freq_vu = 1;
 
+int periods = 1;
+int n_threads = 1;
+uint64_t period_dt = 30000000;
+int sim_threads = 1;
+int batch_size = 1;
+int data_type_width = 2;
+
 bool do_par = false;
-char const *rand_chars[] = {"a", "b", "c", "d", "e", "f",
-                            "g", "h", "i", "j", "k", "l",
-                            "m", "n", "o", "p", "q", "r",
-                            "s", "t", "u", "v", "w", "x",
-                            "y", "z", "A", "B", "C", "D",
-                            "E", "F", "G", "H", "I", "J",
-                            "K", "L", "M", "N", "O", "P",
-                            "Q", "R", "S", "T", "U", "V",
-                            "W", "X", "Y", "Z", "0", "1",
-                            "2", "3", "4", "5", "6", "7",
-                            "aa", "ab", "ac", "ad", "ae",
-                            "af", "ag", "ah", "ai", "aj",
-                            "ak", "al", "am", "an", "ao",
-                            "ap", "aq", "ar", "as", "at",
-                            "au", "av", "aw", "ax", "ay"};
 
-int div_ru(int q, int r) {
-    return int(std::ceil(float(q) / (float) r));
+// Set by ArchParser::parse_args, kept here so the library links without main.cc
+std::string layer_file;
+std::string ofile;
+
+int64_t div_ru(int64_t q, int64_t r) {
+  return (q + r - 1) / r;
+}
+
+int dtype_width(const std::string &name) {
+  if (name == "int8" || name == "fp8") return 1;
+  if (name == "bf16" || name == "fp16") return 2;
+  if (name == "fp32") return 4;
+  size_t used = 0;
+  int width = 0;
+  try {
+    width = std::stoi(name, &used);
+  } catch (const std::logic_error &) {
+  }
+  if (used != name.size() || width < 1) {
+    throw std::runtime_error("unknown datatype '" + name + "', expected int8, fp8, bf16, fp16, fp32 or a byte count");
+  }
+  return width;
 }
@@ -8,88 +8,59 @@
  */
 
 #include "frontends/Frontend.h"
+#include "frontends/standard/Fusion.h"
+#include "frontends/standard/LLMInference.h"
+#include "frontends/standard/Mapper.h"
+#include "frontends/standard/StandardArch.h"
 #include "frontends/standard/StandardLayer.h"
 #include "frontends/standard/StandardParser.h"
-
+#include "frontends/torch/TorchLayer.h"
+
+#include "Checkpoint.h"
+#include "CriticalPath.h"
+#include "Energy.h"
+#include "Fork.h"
+#include "Profiler.h"
+#include "Serving.h"
+#include "Throughput.h"
+#include "Timeline.h"
+#include "Trace.h"
+#include "Waveform.h"
+#include "WhatIf.h"
 #include "memory.h"
 #include <chrono>
 
-std::string layer_file;
-std::string ofile;
-
 using namespace frontend::standard;
 
 using MyArchParser = StandardParser;
 using MyLayerParser = StandardLayer;
+using MyGraphParser = frontend::torch::TorchLayer;
 
-int main(int argc, char **argv) {
-  MyArchParser archParser(argc, argv);
-  MyLayerParser layerParser;
-
-  auto t1 = std::chrono::high_resolution_clock::now();
-  mem::setup();
-
-#ifdef VCD
-  vcd = fopen("out.vcd", "w");
-#endif
-
-  Arch *arch = archParser.make_arch();
-  arch->init_waveforms();
-
-  std::string line;
-  std::vector<LayerConfig> layer_configs;
-
-  std::ifstream layer_stream(layer_file);
-  if (!layer_stream.is_open()) {
-    throw std::runtime_error("Error: Could not open layer configuration file: " + layer_file);
-  }
+static bool is_graph_file(const std::string &fname) {
+  return fname.size() >= 5 && fname.compare(fname.size() - 5, 5, ".json") == 0;
+}
 
-  // Parse layer configuration file (format: layer_name dim1 dim2 ... dim8)
-  int n_layers = 0;
-  while (std::getline(layer_stream, line)) {
-    const char *nt_buff = line.c_str();
-    LayerConfig l_config;
-    char nm[64] = {0};
-    std::cout << "processing " << line << std::endl;
-    
-    // Parse up to 8 dimensions per layer
-    std::vector<int> dims(8);
-    int successes = sscanf(nt_buff, "%s %d %d %d %d %d %d %d %d",
-                           nm,
-                           &dims[0], &dims[1], &dims[2], &dims[3],
-                           &dims[4], &dims[5], &dims[6], &dims[7]);
-    if (successes < 2) {
-      std::cerr << "failed with '" << nt_buff << "'" << std::endl;
-      throw std::exception();
-    }
-    
-    l_config.layer_type = std::string(nm);
-    int n_dims = successes - 1;
-    dims.resize(n_dims);
-    l_config.dimensions = dims;
-    layer_configs.push_back(l_config);
-    n_layers++;
-  }
-  layer_stream.close();
+// Fixed schedule: `periods` copies of the model, `period_dt` cycles apart
+static void run_periods(Arch *arch, const LayerParser &layerParser, FILE *f) {
+  std::vector<LayerConfig> layer_configs = layerParser.read_layers(layer_file);
 
   // Setup multi-period simulation with time-based job enqueuing
   TimeBasedEnqueue time_enqueues;
   uint64_t t = 0;
-  auto dt = 30000000;  // Time between periods
-  std::vector<Job *> period_jobs[periods];
+  std::vector<std::vector<Job *>> period_jobs(periods);
   
   std::cout << "Period: " << periods << std::endl;
   for (int i = 0; i < periods; ++i) {
     // Create jobs for each thread in this period
     for (int j = 0; j < n_threads; ++j) {
       auto network = layerParser.make_layers(layer_configs);
-      for (auto &layer: network) {
+      for (auto &layer: network) {  // graph roots
         period_jobs[i].insert(period_jobs[i].end(), layer.first.begin(), layer.first.end());
       }
       alloc_task_idx++;
     }
     time_enqueues.enqueue_at(t, &period_jobs[i]);
-    t += dt;
+    t += period_dt;
 
     std::cout << "Jobs for Period " << i << ":" << std::endl;
     for (auto *job: period_jobs[i]) {
@@ -102,7 +73,6 @@ int main(int argc, char **argv) {
   mem::mem_sys->ResetStats();
 
   auto res = arch->get_cycles(time_enqueues);
-  FILE *f = fopen(ofile.c_str(), "w");
   for (int p = 0; p < periods; ++p) {
     fprintf(f, "Cycles %llu\n", res[p].cycles);
     for (int i = 0; i < arch->states.size(); ++i) {
@@ -116,12 +86,77 @@ int main(int argc, char **argv) {
   auto expected_c = (double)res[0].cycles;
   double ratio = lc / expected_c;
   printf("Drain Ratio: %f\n", ratio);
+}
+
+int main(int argc, char **argv) {
+  MyArchParser archParser(argc, argv);
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+  prof::start();
+  mem::setup();
+
+
+  Arch *arch = archParser.make_arch();
+  // -dram_threads is only known once make_arch has parsed the flags
+  if (mem::tick_threads > 1) mem::setup();
+  if (server_config.enabled) {
+    // Command-line arch flags are the defaults for requests that leave them out
+    delete arch;
+    cocossim::ArchSpec defaults;
+    defaults.cores = arch_config.n_cores;
+    defaults.sa_sz = arch_config.sa_sz_allo;
+    defaults.vu_sz = arch_config.vu_sz_allo;
+    defaults.ws = arch_config.ws;
+    defaults.freq_ghz = freq_sa;
+    defaults.batch_size = batch_size;
+    defaults.dtype_width = data_type_width;
+    defaults.map = mapper_config.enabled;
+    defaults.map_verify = mapper_config.verify_top;
+    defaults.fuse = fusion_config.enabled;
+    run_server(defaults, std::cin, stdout);
+    return 0;
+  }
+  if (!waveform_config.file.empty()) waveform = new WaveformWriter(waveform_config.file);
+  arch->init_waveforms();
+  if (!trace_file.empty()) arch->trace = new ChromeTrace(trace_file, arch);
+
+  // Exported model graphs (.json) go through the torch.fx importer, everything else is the text format
+  MyLayerParser textParser;
+  MyGraphParser graphParser;
+  auto parser_for = [&](const std::string &fname) -> const LayerParser & {
+    return is_graph_file(fname) ? (const LayerParser &) graphParser : textParser;
+  };
+
+  FILE *f = fopen(ofile.c_str(), "w");
+  setup_forks(arch, f);
+  setup_checkpoints(arch);
+  if (serving_config.enabled()) {
+    run_serving(arch, parser_for, layer_file, f);
+  } else if (whatif_config.report) {
+    auto make_arch = [](int units_per_type) -> Arch * {
+      ArchConfig saved = arch_config;
+      if (units_per_type > 0) arch_config.n_cores = units_per_type;
+      Arch *a = new StandardArch;
+      arch_config = saved;
+      return a;
+    };
+    run_whatif(arch, make_arch, parser_for(layer_file), layer_file, f);
+  } else if (throughput_config.enabled()) {
+    run_throughput(arch, parser_for(layer_file), layer_file, f);
+  } else {
+    run_periods(arch, parser_for(layer_file), f);
+  }
+  report_llm_runs(f, 1. / freq_sa);
+  if (!timeline_file.empty()) write_timeline(arch, timeline_file);
+  if (!critical_path_file.empty()) write_critical_path(arch, critical_path_file);
+  if (!energy_config.file.empty()) write_energy(arch, energy_config.file);
+  delete arch->trace;
 
   fclose(f);
   mem::mem_sys->PrintEpochStats();
-#ifdef VCD
-  fclose(vcd);
-#endif
+  delete waveform;
   auto t2 = std::chrono::high_resolution_clock::now();
   std::cout << "Simulation took " << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() << "ms" << std::endl;
+  prof::print_summary(gcycles, mem::reads_done + mem::writes_done);
+  finish_forks();
 }
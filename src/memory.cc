@@ -9,18 +9,27 @@
 
 #include "memory.h"
 #include "global.h"
+#include "Profiler.h"
+
+#include <map>
+#include <memory>
 
 using namespace mem;
 
 namespace mem {
-  mem_ty *mem_sys;
-  dramsim3::Config *dramsim3config;
+  mem_ty *mem_sys = nullptr;
+  uint64_t reads_done = 0, writes_done = 0;
+  int tick_threads = 1;
+  dramsim3::Config *dramsim3config = nullptr;
   std::unordered_map<uint64_t, State *> address_reads_bkwds_lookup;
   std::unordered_map<uint64_t, State *> address_writes_bkwds_lookup;
 }
 
 static int q = 0;
 
+// Parsed DRAMSim3 configs by (ini file, output dir), a long-running process parses each ini once
+static std::map<std::pair<std::string, std::string>, std::unique_ptr<dramsim3::Config>> parsed_configs;
+
 // Priority comparator for memory transactions (lower priority number = higher priority)
 struct PrioritySorter {
     bool operator()(const std::tuple<uint64_t, bool, int, State *> &first, const std::tuple<uint64_t, bool, int, State *> &second) const {
@@ -56,26 +65,51 @@ bool mem::try_enqueue_tx() {
     return false;
 }
 
-void mem::setup() {
-  dramsim3config = new dramsim3::Config("../dramsim3/configs/HBM2_8Gb_x128.ini", "./");
-  mem_sys = new mem_ty(*dramsim3config, "./", [](uint64_t addr) {
-        auto it = address_reads_bkwds_lookup.find(addr);
-        if (it != address_reads_bkwds_lookup.end()) {
-            State *q = it->second;
-            address_reads_bkwds_lookup.erase(it);
-            q->mem_read_left -= 1;
-        } else {
-            std::cerr << "Error: Address " << std::hex << addr << " not found in address_reads_bkwds_lookup" << std::endl;
-        } }, [](uint64_t addr) {
-        auto it = address_writes_bkwds_lookup.find(addr);
-        if (it != address_writes_bkwds_lookup.end()) {
-            State *q = it->second;
-            address_writes_bkwds_lookup.erase(it);
-            q->mem_write_left -= 1;
-        } else {
-            std::cerr << "Error: Address " << addr << " not found in address_writes_bkwds_lookup" << std::endl;
-        } });
+// Completion callbacks of every DRAM system, they find the unit waiting on the address
+static void read_done(uint64_t addr) {
+  PROF_SCOPE(MEM_CALLBACK);
+  auto it = address_reads_bkwds_lookup.find(addr);
+  if (it != address_reads_bkwds_lookup.end()) {
+    State *q = it->second;
+    address_reads_bkwds_lookup.erase(it);
+    q->mem_read_left -= 1;
+    reads_done++;
+    if (q->j && q->j->first_read_cycle == 0) q->j->first_read_cycle = gcycles;
+  } else {
+    std::cerr << "Error: Address " << std::hex << addr << " not found in address_reads_bkwds_lookup" << std::endl;
+  }
+}
+
+static void write_done(uint64_t addr) {
+  PROF_SCOPE(MEM_CALLBACK);
+  auto it = address_writes_bkwds_lookup.find(addr);
+  if (it != address_writes_bkwds_lookup.end()) {
+    State *q = it->second;
+    address_writes_bkwds_lookup.erase(it);
+    q->mem_write_left -= 1;
+    writes_done++;
+  } else {
+    std::cerr << "Error: Address " << addr << " not found in address_writes_bkwds_lookup" << std::endl;
+  }
+}
+
+static std::string current_output_dir = "./";
+
+mem_ty *mem::make_system() {
+  return new mem_ty(*dramsim3config, current_output_dir, read_done, write_done, tick_threads);
+}
+
+void mem::setup(const std::string &config_file, const std::string &output_dir) {
+  delete mem_sys;
+  to_enqueue.clear();
+  address_reads_bkwds_lookup.clear();
+  address_writes_bkwds_lookup.clear();
+  auto &parsed = parsed_configs[{config_file, output_dir}];
+  if (!parsed) parsed.reset(new dramsim3::Config(config_file, output_dir));
+  dramsim3config = parsed.get();
+  current_output_dir = output_dir;
+  mem_sys = make_system();
   bytes_per_tx = dramsim3config->request_size_bytes;
   std::cout << "REQUEST SIZE BYTES " << bytes_per_tx << std::endl;
 
-}
+}
\ No newline at end of file
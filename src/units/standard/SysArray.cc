@@ -16,38 +16,43 @@
 
 using namespace frontend::standard;
 
-bool SystolicArray::SysArrayState::increment(const std::function<void(Job *)> &enqueue_job, int &total_idle, int *n_idle_units) {
+bool SystolicArray::SysArrayState::increment(int &total_idle, int *n_idle_units) {
+  return ws ? step<true>(total_idle, n_idle_units) : step<false>(total_idle, n_idle_units);
+}
+
+template<bool WS>
+bool SystolicArray::SysArrayState::step(int &total_idle, int *n_idle_units) {
   auto *sj = (SysArrayJob *) j;
   enqueue_reads();
   enqueue_writes();
   if (process_stage()) {
-    if (ws) {  // Weight Stationary mode
+    if constexpr (WS) {  // Weight Stationary mode
       switch (state) {
         case prefetch:  // Load weights into systolic array
           state_transfer(read,
                          0,
                          0,
-                         sj->M * std::max(systolic_fpu_latency, batch_size));
+                         (int64_t) sj->M * std::max(fpu_latency, batch_size));
           break;
         case read:  // Read input activations
           state_transfer(shift,
-                         std::min(sz, sj->K) * std::min(sz, sj->N) * data_type_width,
+                         (int64_t) std::min(sz, sj->K) * std::min(sz, sj->N) * j->weight_width,
                          0,
-                         sz * std::max(systolic_fpu_latency, batch_size));
+                         sz * std::max(fpu_latency, batch_size));
           break;
           
         case shift: {  // Compute phase: shift data through systolic array
-          int amt_to_write = 0;
-          int amt_to_read = 0;
-          int n_cycles = 0;
-          int activation_preload = 0;
+          int64_t amt_to_write = 0;
+          int64_t amt_to_read = 0;
+          int64_t n_cycles = 0;
+          int64_t activation_preload = 0;
           
           // Check if we're at the end of tile computation
           if (col_i == loop_cols_tiles) {
             if (row_i == loop_row_tiles) {
-              amt_to_write = sj->M * sj->N * data_type_width * batch_size;
-            } else {
-              activation_preload = std::min(sz, sj->K) * sj->M * batch_size * data_type_width;
+              amt_to_write = j->writes_output ? (int64_t) sj->M * sj->N * j->act_width * batch_size : 0;
+            } else if (!sj->act_prebuffered) {
+              activation_preload = (int64_t) std::min(sz, sj->K) * sj->M * batch_size * j->act_width;
             }
           }
           amt_to_read = activation_preload;
@@ -55,7 +60,7 @@ bool SystolicArray::SysArrayState::increment(const std::function<void(Job *)> &e
           state_transfer(write, amt_to_read, amt_to_write, n_cycles);
         } break;
         case write: {  // Write output data to memory
-          int rd_cycles = sj->M * std::max(systolic_fpu_latency, batch_size);
+          int64_t rd_cycles = (int64_t) sj->M * std::max(fpu_latency, batch_size);
           if (col_i == loop_cols_tiles) {
             if (row_i == loop_row_tiles) {
               // Job completed
@@ -80,10 +85,10 @@ bool SystolicArray::SysArrayState::increment(const std::function<void(Job *)> &e
     } else {  // Output Stationary mode
       switch (state) {
         case read:  // Read weights and activations
-          state_transfer(shift, 0, 0, sz * std::min(systolic_fpu_latency, batch_size));
+          state_transfer(shift, 0, 0, sz * std::min(fpu_latency, batch_size));
           break;
         case shift:  // Compute and accumulate outputs
-          state_transfer(write, 0, beats_per_wb, 0);
+          state_transfer(write, 0, j->writes_output ? beats_per_wb : 0, 0);
           break;
         case write:  // Write partial sums back to memory
           if (col_i == loop_cols_tiles) {
@@ -125,18 +130,19 @@ bool SystolicArray::SysArrayState::increment(const std::function<void(Job *)> &e
 void SystolicArray::SysArrayState::init_row_loop(bool new_row) {
   auto sj = (SysArrayJob *) j;
 
-  int n_read_bytes = 0;
-  int n_read_beats = 0;
+  int64_t n_read_bytes = 0;
+  int64_t n_read_beats = 0;
   if (ws) {
     throw std::exception();
   } else {
-    min_stage_cycles = sj->K * systolic_fpu_latency;
+    min_stage_cycles = (int64_t) sj->K * fpu_latency;
+    int64_t act_bytes = sj->act_prebuffered ? 0 : batch_size * j->act_width;
     if (new_row) {
-      n_read_bytes = std::min(sz, sj->M) * sj->K * (batch_size + (j->batched_weights ? batch_size : 1)) * data_type_width;
+      n_read_bytes = (int64_t) std::min(sz, sj->M) * sj->K * (act_bytes + (j->batched_weights ? batch_size : 1) * j->weight_width);
     } else {
-      n_read_bytes = std::min(sz, sj->M) * sj->K * (j->batched_weights ? batch_size : 1) * data_type_width;
+      n_read_bytes = (int64_t) std::min(sz, sj->M) * sj->K * (j->batched_weights ? batch_size : 1) * j->weight_width;
     }
-    n_read_beats = std::max(n_read_bytes / bytes_per_tx, 1);
+    n_read_beats = std::max<int64_t>(n_read_bytes / bytes_per_tx, 1);
   }
   mem_read_left = mem_read_left_unqueued = n_read_beats;
 }
@@ -146,20 +152,25 @@ void SystolicArray::SysArrayState::init() {
   if (j->is_done) {
     std::cerr << "ERROR" << std::endl;
   }
+  j->ops += (uint64_t) sj->M * sj->K * sj->N * batch_size;
+  // A MAC takes longer on wider elements, narrower ones pack into the same PEs
+  fpu_latency = std::max(1, systolic_fpu_latency * std::max(j->act_width, j->weight_width) / 2);
+  beats_per_wb = std::max((sz * sz * j->act_width * batch_size) / bytes_per_tx, 1);
   if (ws) {
     UPDATE_STATE(SystolicArray::prefetch);
     loop_cols_tiles = div_ru(sj->N, sz);
     loop_row_tiles = div_ru(sj->K, sz);
-    int sys_array_preload = std::min(sz, sj->N) * std::min(sz, sj->K) * data_type_width;
-    int activation_preload = std::min(sz, sj->K) * sj->M * data_type_width;
+    int64_t sys_array_preload = (int64_t) std::min(sz, sj->N) * std::min(sz, sj->K) * j->weight_width;
+    int64_t activation_preload = sj->act_prebuffered ? 0 : (int64_t) std::min(sz, sj->K) * sj->M * j->act_width;
     state_transfer(SystolicArray::prefetch, activation_preload + sys_array_preload, 0, sz);
     row_i = 1;
     col_i = 1;
   } else {
     UPDATE_STATE(SystolicArray::read);
-    min_stage_cycles = sj->K * std::max(systolic_fpu_latency, batch_size);
-    int n_read_bytes = std::min(sz, sj->M) * sj->K * (batch_size + (j->batched_weights ? batch_size : 1)) * data_type_width;
-    int n_read_beats = n_read_bytes / bytes_per_tx;
+    min_stage_cycles = (int64_t) sj->K * std::max(fpu_latency, batch_size);
+    int64_t act_bytes = sj->act_prebuffered ? 0 : batch_size * j->act_width;
+    int64_t n_read_bytes = (int64_t) std::min(sz, sj->M) * sj->K * (act_bytes + (j->batched_weights ? batch_size : 1) * j->weight_width);
+    int64_t n_read_beats = n_read_bytes / bytes_per_tx;
     mem_read_left = mem_read_left_unqueued = n_read_beats;
 
     loop_cols_tiles = std::max(sj->N / sz, 1);
@@ -174,12 +185,22 @@ void SystolicArray::SysArrayState::init() {
     throw std::runtime_error("loop_cols_tiles == 0");
 }
 
+void SystolicArray::SysArrayState::save(std::ostream &out) {
+  State::save(out);
+  out << fpu_latency << ' ' << beats_per_wb << '\n';
+}
+
+void SystolicArray::SysArrayState::load(std::istream &in) {
+  State::load(in);
+  in >> fpu_latency >> beats_per_wb;
+}
+
 SystolicArray::SysArrayState::SysArrayState(int sz, bool ws) : State(1), sz(sz), ws(ws), state(SystolicArray::idle) {
-  beats_per_wb = std::max((sz * sz * data_type_width * batch_size) / bytes_per_tx, 1);
+  State::sz = sz;
 }
 
 SystolicArray::SysArrayJob::SysArrayJob(int m, int k, int n)
-    : Job(m * m * n * data_type_width * batch_size * 2 + n * m * data_type_width * batch_size), M(m), K(k), N(n) {}
+    : Job((uint64_t) m * m * n * alloc_act_width * batch_size * 2 + (uint64_t) n * m * alloc_act_width * batch_size), M(m), K(k), N(n) {}
 
 
 std::string SystolicArray::SysArrayJob::get_job_dims_string() const {
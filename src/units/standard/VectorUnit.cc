@@ -15,9 +15,9 @@
 
 using namespace VectorUnit;
 
-bool VecUnitState::increment(const std::function<void(Job *)> &enqueue_job, int &total_idle, int *n_idle_units) {
+bool VecUnitState::increment(int &total_idle, int *n_idle_units) {
   auto *sj = (VecUnitJob *) j;
-  int lin, par;
+  int64_t lin, par;
   switch (state) {
     case VectorUnit::VPUState::unbuffered_lin:
     case VectorUnit::VPUState::unbuffered_par:
@@ -34,16 +34,18 @@ bool VecUnitState::increment(const std::function<void(Job *)> &enqueue_job, int
           // All phases completed, write results
           state_transfer(VectorUnit::VPUState::write,
                          0,
-                         lin * par * data_type_width * batch_size,
+                         sj->writes_output ? lin * par * j->act_width * batch_size : 0,
                          0);
         } else if (ph_ar.front().first == VPUPhase::REDUCE) {
           // Reduction phase: compute along linear dimension
+          j->ops += (uint64_t) lin * par * batch_size * ph_ar.front().second;
           state_transfer(VectorUnit::VPUState::buffered_lin,
                          0, 0,
                          ph_ar.front().second * lin * div_ru(par, sz));
           ph_ar.pop();
         } else if (ph_ar.front().first == VPUPhase::BROADCAST) {
           // Broadcast phase: distribute values across parallel dimension
+          j->ops += (uint64_t) lin * par * batch_size * ph_ar.front().second;
           state_transfer(VectorUnit::VPUState::buffered_par,
                          0, 0,
                          div_ru(lin * par * ph_ar.front().second, sz));
@@ -76,8 +78,8 @@ void VecUnitState::init() {
   LOG_TO_WAVEFORM(STAT_ID(JOB_IDX, vcd_idx), j->job_idx);
 
   VectorUnit::VPUState first_state;
-  int first_phase_read;
-  int first_phase_cycles;
+  int64_t first_phase_read;
+  int64_t first_phase_cycles;
   auto front = sj->phases.front();
   if (sj->is_prebuffered) {
     first_phase_read = 0;
@@ -87,7 +89,7 @@ void VecUnitState::init() {
       first_state = VectorUnit::VPUState::buffered_lin;
     }
   } else {
-    first_phase_read = sj->linearized_dimension * sj->parallel_dimension * batch_size * data_type_width;
+    first_phase_read = (int64_t) sj->linearized_dimension * sj->parallel_dimension * batch_size * j->act_width * sj->n_operands;
     if (front.first == VPUPhase::BROADCAST) {
       first_state = VectorUnit::VPUState::unbuffered_par;
     } else {
@@ -95,10 +97,11 @@ void VecUnitState::init() {
     }
   }
   if (front.first == VPUPhase::BROADCAST) {
-    first_phase_cycles = div_ru(sj->linearized_dimension * sj->parallel_dimension * front.second, sz);
+    first_phase_cycles = div_ru((int64_t) sj->linearized_dimension * sj->parallel_dimension * front.second, sz);
   } else {
-    first_phase_cycles = sj->linearized_dimension * std::max(batch_size, front.second) * div_ru(sj->parallel_dimension, sz);
+    first_phase_cycles = (int64_t) sj->linearized_dimension * std::max(batch_size, front.second) * div_ru(sj->parallel_dimension, sz);
   }
+  j->ops += (uint64_t) sj->linearized_dimension * sj->parallel_dimension * batch_size * front.second;
   state_transfer(first_state,
                  first_phase_read,
                  0,
@@ -111,6 +114,7 @@ void VecUnitState::init() {
 }
 
 VecUnitState::VecUnitState(int sz) : State(2), sz(sz) {
+  State::sz = sz;
   beats_per_wb = std::max((sz * batch_size) / bytes_per_tx, 1);
 }
 
@@ -122,23 +126,39 @@ VecUnitJob::VecUnitJob(int linearizedDimension,
                        int parallelDimension,
                        bool is_prebuffered,
                        const std::queue<std::pair<VPUPhase, int>> &phases)
-    : Job(linearizedDimension * parallelDimension * data_type_width * batch_size),
+    : Job((uint64_t) linearizedDimension * parallelDimension * alloc_act_width * batch_size),
       linearized_dimension(linearizedDimension),
       parallel_dimension(parallelDimension),
       is_prebuffered(is_prebuffered),
-      phases(phases) {}
+      phases(phases),
+      phases_hold(phases) {}
 
 VecUnitJob::VecUnitJob(int linearizedDimension,
                        int parallelDimension,
                        bool is_prebuffered,
                        const std::vector<std::pair<VPUPhase, int>> &vphases)
-    : Job(linearizedDimension * parallelDimension * data_type_width * batch_size),
+    : Job((uint64_t) linearizedDimension * parallelDimension * alloc_act_width * batch_size),
       linearized_dimension(linearizedDimension),
       parallel_dimension(parallelDimension),
       is_prebuffered(is_prebuffered) {
   for (const auto &q: vphases) {
     phases.push(q);
   }
+  phases_hold = phases;
+}
+
+void VecUnitJob::save(std::ostream &out) const {
+  Job::save(out);
+  out << phases.size() << '\n';
+}
+
+void VecUnitJob::load(std::istream &in) {
+  Job::load(in);
+  // The phases left are the last ones of phases_hold
+  size_t left = 0;
+  in >> left;
+  phases = phases_hold;
+  while (phases.size() > left) phases.pop();
 }
 
 int VecUnitJob::get_type() const {